@@ -0,0 +1,209 @@
+#pragma once
+#ifndef _VERTEX_STREAM_H_
+#define _VERTEX_STREAM_H_
+
+#include <vector>
+#include <cstring>
+#include <glad/glad.h>
+
+// gladֻصGL 3.3glBufferStorage4.4 / ARB_buffer_storageҪԼȡ
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+namespace Stream {
+
+	using std::vector;
+
+	typedef void (APIENTRYP BufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+	// ÿ֡ɵĶԴVAOlocation 0Ϊcomponentsfloat
+	// ֧glBufferStorageʱһ־áһӳĻֳframesʹã
+	//   ÿ֡ĩһfence´ֵһʱȵGPUֱ꣬ӳڴд
+	// GL 3.3дglBufferData(NULL)ɻ壬ÿUNSYNCHRONIZEDӳһС
+	// ÷beginFrame() -> map()/unmap()  push() -> draw() -> endFrame()
+	class VertexStream {
+	public:
+		VertexStream() {}
+		~VertexStream() {
+			destroy();
+		}
+
+		// capacityΪÿ֡дĶʱԶloadһ㴫glfwGetProcAddress
+		void create(int components_, int capacity_, GLADloadproc load, int frames_ = 3) {
+			destroy();
+			components = components_;
+			capacity = capacity_ > 0 ? capacity_ : 1;
+			frames = frames_;
+			bufferStorage = NULL;
+			if (load && hasBufferStorage()) bufferStorage = (BufferStorageProc)load("glBufferStorage");
+			glGenVertexArrays(1, &VAO);
+			allocate();
+		}
+
+		void destroy() {
+			if (!VAO) return;
+			waitAll();
+			release();
+			glDeleteVertexArrays(1, &VAO);
+			VAO = 0;
+		}
+
+		bool persistent() const {
+			return bufferStorage != NULL;
+		}
+
+		void beginFrame() {
+			if (!persistent()) return;
+			region = (region + 1) % frames;
+			wait(region);
+			cursor = region * capacity;
+		}
+
+		void endFrame() {
+			if (!persistent()) return;
+			fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+
+		// Ԥcount㲢ؿдָ룬дunmap
+		// count <= 0ʱӳ䣨Ϊ0glMapBufferRangeGL_INVALID_VALUEصָ벻д
+		float* map(int count) {
+			pending = count > 0 ? count : 0;
+			rangeMapped = false;
+			if (count <= 0) return &empty;
+			if (persistent()) {
+				if (cursor + count > (region + 1) * capacity) {
+					grow(cursor - region * capacity + count);
+					cursor = region * capacity;
+				}
+				return mapped + (size_t)cursor * components;
+			}
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			if (count > capacity) grow(count);
+			if (cursor + count > capacity) {
+				glBufferData(GL_ARRAY_BUFFER, bytes(capacity), NULL, GL_STREAM_DRAW);
+				cursor = 0;
+			}
+			float* p = (float*)glMapBufferRange(GL_ARRAY_BUFFER, bytes(cursor), bytes(count),
+				GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+			rangeMapped = p != NULL;
+			return p;
+		}
+
+		// ݵĵһ㣬ֱӸglDrawArrays
+		GLint unmap() {
+			if (rangeMapped) {
+				glBindBuffer(GL_ARRAY_BUFFER, VBO);
+				glUnmapBuffer(GL_ARRAY_BUFFER);
+				rangeMapped = false;
+			}
+			GLint first = cursor;
+			cursor += pending;
+			pending = 0;
+			return first;
+		}
+
+		// Ѿvectorݿһνȥ
+		GLint push(const vector<float>& data) {
+			int count = (int)(data.size() / components);
+			float* p = map(count);
+			if (p && count > 0) memcpy(p, data.data(), bytes(count));
+			return unmap();
+		}
+
+		void draw(GLenum mode, GLint first, GLsizei count) {
+			glBindVertexArray(VAO);
+			glDrawArrays(mode, first, count);
+		}
+
+	private:
+		BufferStorageProc bufferStorage = NULL;
+		GLuint VAO = 0, VBO = 0;
+		int components = 3, capacity = 0, frames = 3;
+		int region = 0, cursor = 0, pending = 0;
+		float* mapped = NULL;
+		bool rangeMapped = false;   // GL 3.3·map()Ƿӳһ
+		float empty = 0.0f;
+		vector<GLsync> fences;
+
+		VertexStream(const VertexStream&);
+		VertexStream& operator=(const VertexStream&);
+
+		GLsizeiptr bytes(int count) const {
+			return (GLsizeiptr)count * components * sizeof(float);
+		}
+
+		bool hasBufferStorage() const {
+			GLint major = 0, minor = 0, n = 0;
+			glGetIntegerv(GL_MAJOR_VERSION, &major);
+			glGetIntegerv(GL_MINOR_VERSION, &minor);
+			if (major > 4 || (major == 4 && minor >= 4)) return true;
+			glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+			for (int i = 0; i < n; i++) {
+				const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+				if (ext && strcmp(ext, "GL_ARB_buffer_storage") == 0) return true;
+			}
+			return false;
+		}
+
+		// 岢ָVAOĶʽ
+		void allocate() {
+			glGenBuffers(1, &VBO);
+			glBindVertexArray(VAO);
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			if (persistent()) {
+				GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+				bufferStorage(GL_ARRAY_BUFFER, bytes(capacity * frames), NULL, flags);
+				mapped = (float*)glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes(capacity * frames), flags);
+				fences.assign(frames, (GLsync)0);
+			}
+			else {
+				glBufferData(GL_ARRAY_BUFFER, bytes(capacity), NULL, GL_STREAM_DRAW);
+			}
+			cursor = persistent() ? region * capacity : 0;
+			glVertexAttribPointer(0, components, GL_FLOAT, GL_FALSE, components * sizeof(float), (void*)0);
+			glEnableVertexAttribArray(0);
+			glBindVertexArray(0);
+		}
+
+		void release() {
+			if (persistent() && mapped) {
+				glBindBuffer(GL_ARRAY_BUFFER, VBO);
+				glUnmapBuffer(GL_ARRAY_BUFFER);
+			}
+			mapped = NULL;
+			if (VBO) glDeleteBuffers(1, &VBO);
+			VBO = 0;
+		}
+
+		// countΪһ֡ҪдĶ־ӳĻСɱ䣬ֻܵжζһµ
+		void grow(int count) {
+			while (capacity < count) capacity *= 2;
+			if (persistent()) {
+				waitAll();
+				release();
+				allocate();
+			}
+			else {
+				glBufferData(GL_ARRAY_BUFFER, bytes(capacity), NULL, GL_STREAM_DRAW);
+				cursor = 0;
+			}
+		}
+
+		void wait(int i) {
+			if (i >= (int)fences.size() || !fences[i]) return;
+			while (glClientWaitSync(fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED);
+			glDeleteSync(fences[i]);
+			fences[i] = 0;
+		}
+
+		void waitAll() {
+			for (int i = 0; i < (int)fences.size(); i++) wait(i);
+		}
+	};
+}
+
+#endif
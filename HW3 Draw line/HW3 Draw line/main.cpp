@@ -5,6 +5,8 @@
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include "Bresenham.h"
+#include "VertexStream.h"
+#include "GLHandle.h"
 #include <iostream>
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -116,9 +118,8 @@ int main()
 		0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f,
 		-1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f
 	};
-	unsigned int VBO, VAO;
-	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
+	Resource::VertexArray VAO = Resource::VertexArray::create();
+	Resource::Buffer VBO = Resource::Buffer::create();
 	// bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
 	glBindVertexArray(VAO);
 
@@ -131,6 +132,10 @@ int main()
 	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
 	glEnableVertexAttribArray(1);
 
+	// the rasterized points are regenerated every frame and streamed instead of re-uploaded with glBufferData
+	Stream::VertexStream stream;
+	stream.create(3, 4096, (GLADloadproc)glfwGetProcAddress);
+
 	// Bresenham algorithm
 	int triVertices[6] = {-90, 20, 90, 70, 10, -50};
 	
@@ -141,19 +146,13 @@ int main()
 			Bresenham::Point(-50, 20),
 			Bresenham::Point(-8, 100));
 
-	unsigned int HW3B1_VAO, HW3B1_VBO;
-	Bresenham::pointsBindVAO(HW3B1_VAO, HW3B1_VBO, triPoints);
 
 	int radius = 50;
 	auto circlePoints = Bresenham::genCirclePositions(Bresenham::Point(0, 0), radius);
-	unsigned int HW3B2_VAO, HW3B2_VBO;
-	Bresenham::pointsBindVAO(HW3B2_VAO, HW3B2_VBO, circlePoints);
 
 	auto filledTriPoints = Bresenham::genFilledTriPoints(Bresenham::Point(triVertices[0], triVertices[1]),
 		Bresenham::Point(triVertices[2], triVertices[3]),
 		Bresenham::Point(triVertices[4], triVertices[5]));
-	unsigned int HW3N1_VAO, HW3N1_VBO;
-	Bresenham::pointsBindVAO(HW3N1_VAO, HW3N1_VBO, filledTriPoints);
 
 	// as we only have a single shader, we could also just activate our shader once beforehand if we want to 
 	glUseProgram(shaderProgram);
@@ -204,6 +203,7 @@ int main()
 
 		// render
 		// ------
+		stream.beginFrame();
 
 		// update shader uniform
 		int vertexColorLocation = glGetUniformLocation(shaderProgram, "ourColor");
@@ -214,38 +214,33 @@ int main()
 				Bresenham::Point(triVertices[2], triVertices[3]),
 				Bresenham::Point(triVertices[4], triVertices[5]));
 
-			glBindVertexArray(HW3B1_VAO);
-			glBindBuffer(GL_ARRAY_BUFFER, HW3B1_VBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triPoints.size(), triPoints.data(), GL_DYNAMIC_DRAW);
+			GLint first = stream.push(triPoints);
 			glPointSize(3);
 			glClear(GL_COLOR_BUFFER_BIT);
-			glDrawArrays(GL_POINTS, 0, triPoints.size() / 3);
+			stream.draw(GL_POINTS, first, triPoints.size() / 3);
 		} else if (HW_choose == HW3_Basic2) {
 
 			circlePoints = Bresenham::genCirclePositions(Bresenham::Point(0, 0), radius);
 			
-			glBindVertexArray(HW3B2_VAO);
-			glBindBuffer(GL_ARRAY_BUFFER, HW3B2_VBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * circlePoints.size(), circlePoints.data(), GL_DYNAMIC_DRAW);
+			GLint first = stream.push(circlePoints);
 			
 			glPointSize(3);
 
 			glClear(GL_COLOR_BUFFER_BIT);
-			glDrawArrays(GL_POINTS, 0, circlePoints.size() / 3);
+			stream.draw(GL_POINTS, first, circlePoints.size() / 3);
 		} else if (HW_choose == HW3_Bonus1) {
 			
 			filledTriPoints = Bresenham::genFilledTriPoints(Bresenham::Point(triVertices[0], triVertices[1]),
 				Bresenham::Point(triVertices[2], triVertices[3]),
 				Bresenham::Point(triVertices[4], triVertices[5]));
 			
-			glBindVertexArray(HW3N1_VAO);
-			glBindBuffer(GL_ARRAY_BUFFER, HW3N1_VBO);
-			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * filledTriPoints.size(), filledTriPoints.data(), GL_DYNAMIC_DRAW);
+			GLint first = stream.push(filledTriPoints);
 			
 			glPointSize(3);
 			glClear(GL_COLOR_BUFFER_BIT);
-			glDrawArrays(GL_POINTS, 0, filledTriPoints.size() / 3);
+			stream.draw(GL_POINTS, first, filledTriPoints.size() / 3);
 		}
+		stream.endFrame();
 		
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 		glfwMakeContextCurrent(window);
@@ -253,6 +248,8 @@ int main()
 		// -------------------------------------------------------------------------------
 		glfwSwapBuffers(window);
 		glfwPollEvents();
+		// objects released during this frame are deleted once the GPU has finished with them
+		Resource::deletionQueue.endFrame();
 	}
 
 	//delete []HW3B1_vertices;
@@ -260,12 +257,10 @@ int main()
 	// ------------------------------------------------------------------------
 	//glDeleteVertexArrays(1, &HW2B3_VAO);
 	//glDeleteBuffers(1, &HW2B3_VBO); 
-	glDeleteVertexArrays(1, &HW3B1_VAO);
-	glDeleteBuffers(1, &HW3B1_VBO);
-	glDeleteVertexArrays(1, &HW3N1_VAO);
-	glDeleteBuffers(1, &HW3N1_VBO);
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(1, &VBO);
+	stream.destroy();
+	VAO.reset();
+	VBO.reset();
+	Resource::deletionQueue.flush();
 	// glfw: terminate, clearing all previously allocated GLFW resources.
 	// ------------------------------------------------------------------
 	glfwTerminate();
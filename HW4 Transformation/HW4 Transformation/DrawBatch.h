@@ -0,0 +1,234 @@
+#pragma once
+#ifndef _DRAW_BATCH_H_
+#define _DRAW_BATCH_H_
+
+#include <vector>
+#include <cstring>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// gladֻصGL 3.3glMultiDrawElementsIndirect4.3 / ARB_multi_draw_indirectҪԼȡ
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+namespace Batch {
+
+	using std::vector;
+
+	struct DrawElementsIndirectCommand {
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	typedef void (APIENTRYP MultiDrawElementsIndirectProc)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+	// һVBOEBOÿ֡ǼҪ(, 任)submitʱͬһĺϳһʵ
+	// 任д壨GL 3.1УÿʵһdivisorΪ1drawIndexҵԼı任
+	//   ɫΪ mat4(texelFetch(transforms, drawIndex * 4 + 0..3))
+	// ֧glMultiDrawElementsIndirect4.3ARB_multi_draw_indirect + ARB_base_instanceʱһύȫ
+	//   baseInstancedrawIndexӸĵһ任ʼ
+	// ÿһglDrawElementsInstancedBaseVertex֮ǰdrawIndexԵƫŲĵһ任
+	class DrawBatch {
+	public:
+		DrawBatch() {}
+		~DrawBatch() {
+			destroy();
+		}
+
+		// loadһ㴫glfwGetProcAddressΪNULLʱʵunitΪ任ռõԪ
+		void create(GLADloadproc load, GLuint drawIndexLocation_, GLenum unit_ = GL_TEXTURE3) {
+			destroy();
+			drawIndexLocation = drawIndexLocation_;
+			unit = unit_;
+			multiDraw = NULL;
+			if (load && hasMultiDrawIndirect()) multiDraw = (MultiDrawElementsIndirectProc)load("glMultiDrawElementsIndirect");
+			glGenVertexArrays(1, &VAO);
+			glGenBuffers(1, &VBO);
+			glGenBuffers(1, &EBO);
+			glGenBuffers(1, &drawIndexBuffer);
+			glGenBuffers(1, &transformBuffer);
+			glGenBuffers(1, &commandBuffer);
+			glGenTextures(1, &transformTexture);
+			glBindBuffer(GL_TEXTURE_BUFFER, transformBuffer);
+			glBufferData(GL_TEXTURE_BUFFER, sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+			glBindTexture(GL_TEXTURE_BUFFER, transformTexture);
+			glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, transformBuffer);
+			glBindTexture(GL_TEXTURE_BUFFER, 0);
+			glBindBuffer(GL_TEXTURE_BUFFER, 0);
+			drawIndexCapacity = 0;
+		}
+
+		void destroy() {
+			if (!VAO) return;
+			glDeleteVertexArrays(1, &VAO);
+			GLuint buffers[] = { VBO, EBO, drawIndexBuffer, transformBuffer, commandBuffer };
+			glDeleteBuffers(5, buffers);
+			glDeleteTextures(1, &transformTexture);
+			VAO = VBO = EBO = drawIndexBuffer = transformBuffer = commandBuffer = transformTexture = 0;
+			meshes.clear();
+			vertices.clear();
+			indices.clear();
+		}
+
+		bool indirect() const {
+			return multiDraw != NULL;
+		}
+
+		// һ񣬶ͬһʽstrideֽڣΪ1632λ
+		// ȫupload
+		int addMesh(const void* vertexData, int vertexCount, int stride, const void* indexData, GLenum indexType, int indexCount) {
+			Range r;
+			r.firstIndex = (GLuint)indices.size();
+			r.count = (GLuint)indexCount;
+			r.baseVertex = (GLint)(vertices.size() / stride);
+			const unsigned char* v = (const unsigned char*)vertexData;
+			vertices.insert(vertices.end(), v, v + (size_t)vertexCount * stride);
+			for (int i = 0; i < indexCount; i++) {
+				if (indexType == GL_UNSIGNED_SHORT) indices.push_back(((const unsigned short*)indexData)[i]);
+				else indices.push_back(((const unsigned int*)indexData)[i]);
+			}
+			meshes.push_back(r);
+			return (int)meshes.size() - 1;
+		}
+
+		// 񴫵GPULΪʽVertexLayout
+		template<typename L>
+		void upload() {
+			glBindVertexArray(VAO);
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			glBufferData(GL_ARRAY_BUFFER, vertices.size(), vertices.data(), GL_STATIC_DRAW);
+			L::apply();
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+			growDrawIndex(64);
+			glBindVertexArray(0);
+		}
+
+		// ʼǼһ֡һ飩Ļ
+		void begin() {
+			instances.clear();
+		}
+
+		void draw(int mesh, const glm::mat4& transform) {
+			Instance i;
+			i.mesh = mesh;
+			i.transform = transform;
+			instances.push_back(i);
+		}
+
+		// ύǼǵȫƣʵʵdraw call
+		int submit(GLenum mode = GL_TRIANGLES) {
+			if (instances.empty()) return 0;
+			// źñ任ͬһı任
+			vector<GLuint> first(meshes.size() + 1, 0);
+			for (auto& i : instances) first[i.mesh + 1]++;
+			for (size_t m = 0; m < meshes.size(); m++) first[m + 1] += first[m];
+			vector<GLuint> cursor(first.begin(), first.end() - 1);
+			transforms.resize(instances.size() * 16);
+			for (auto& i : instances) memcpy(&transforms[cursor[i.mesh]++ * 16], &i.transform[0][0], 16 * sizeof(float));
+
+			commands.clear();
+			for (size_t m = 0; m < meshes.size(); m++) {
+				if (first[m + 1] == first[m]) continue;
+				DrawElementsIndirectCommand c;
+				c.count = meshes[m].count;
+				c.instanceCount = first[m + 1] - first[m];
+				c.firstIndex = meshes[m].firstIndex;
+				c.baseVertex = meshes[m].baseVertex;
+				c.baseInstance = first[m];
+				commands.push_back(c);
+			}
+
+			glBindBuffer(GL_TEXTURE_BUFFER, transformBuffer);
+			glBufferData(GL_TEXTURE_BUFFER, transforms.size() * sizeof(float), transforms.data(), GL_STREAM_DRAW);
+			glBindBuffer(GL_TEXTURE_BUFFER, 0);
+			glActiveTexture(unit);
+			glBindTexture(GL_TEXTURE_BUFFER, transformTexture);
+			glActiveTexture(GL_TEXTURE0);
+
+			glBindVertexArray(VAO);
+			growDrawIndex((GLuint)instances.size());
+			int calls;
+			if (indirect()) {
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+				glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_STREAM_DRAW);
+				multiDraw(mode, GL_UNSIGNED_INT, (void*)0, (GLsizei)commands.size(), 0);
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+				calls = 1;
+			}
+			else {
+				glBindBuffer(GL_ARRAY_BUFFER, drawIndexBuffer);
+				for (auto& c : commands) {
+					glVertexAttribIPointer(drawIndexLocation, 1, GL_UNSIGNED_INT, 0, (void*)(sizeof(GLuint) * c.baseInstance));
+					glDrawElementsInstancedBaseVertex(mode, c.count, GL_UNSIGNED_INT, (void*)(sizeof(GLuint) * c.firstIndex), c.instanceCount, c.baseVertex);
+				}
+				calls = (int)commands.size();
+			}
+			glBindVertexArray(0);
+			return calls;
+		}
+
+	private:
+		struct Range {
+			GLuint firstIndex, count;
+			GLint baseVertex;
+		};
+
+		struct Instance {
+			int mesh;
+			glm::mat4 transform;
+		};
+
+		MultiDrawElementsIndirectProc multiDraw = NULL;
+		GLuint VAO = 0, VBO = 0, EBO = 0;
+		GLuint drawIndexBuffer = 0, transformBuffer = 0, commandBuffer = 0, transformTexture = 0;
+		GLuint drawIndexLocation = 3, drawIndexCapacity = 0;
+		GLenum unit = GL_TEXTURE3;
+		vector<Range> meshes;
+		vector<unsigned char> vertices;
+		vector<GLuint> indices;
+		vector<Instance> instances;
+		vector<float> transforms;
+		vector<DrawElementsIndirectCommand> commands;
+
+		DrawBatch(const DrawBatch&);
+		DrawBatch& operator=(const DrawBatch&);
+
+		bool hasMultiDrawIndirect() const {
+			GLint major = 0, minor = 0, n = 0;
+			glGetIntegerv(GL_MAJOR_VERSION, &major);
+			glGetIntegerv(GL_MINOR_VERSION, &minor);
+			if (major > 4 || (major == 4 && minor >= 3)) return true;
+			bool multi = false, base = false;
+			glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+			for (int i = 0; i < n; i++) {
+				const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+				if (!ext) continue;
+				if (strcmp(ext, "GL_ARB_multi_draw_indirect") == 0) multi = true;
+				if (strcmp(ext, "GL_ARB_base_instance") == 0) base = true;
+			}
+			return multi && base;
+		}
+
+		// drawIndexԵݹ̶Ϊ0, 1, 2 ...ʱؽǰѰVAO
+		void growDrawIndex(GLuint count) {
+			if (count > drawIndexCapacity) {
+				while (drawIndexCapacity < count) drawIndexCapacity = drawIndexCapacity ? drawIndexCapacity * 2 : 64;
+				vector<GLuint> ids(drawIndexCapacity);
+				for (GLuint i = 0; i < drawIndexCapacity; i++) ids[i] = i;
+				glBindBuffer(GL_ARRAY_BUFFER, drawIndexBuffer);
+				glBufferData(GL_ARRAY_BUFFER, ids.size() * sizeof(GLuint), ids.data(), GL_STATIC_DRAW);
+			}
+			glBindBuffer(GL_ARRAY_BUFFER, drawIndexBuffer);
+			glVertexAttribIPointer(drawIndexLocation, 1, GL_UNSIGNED_INT, 0, (void*)0);
+			glVertexAttribDivisor(drawIndexLocation, 1);
+			glEnableVertexAttribArray(drawIndexLocation);
+		}
+	};
+}
+
+#endif
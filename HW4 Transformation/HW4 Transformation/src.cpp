@@ -5,6 +5,8 @@
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include "HW4.h"
+#include "VertexLayout.h"
+#include "DrawBatch.h"
 #include <iostream>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -20,15 +22,23 @@ const unsigned int SCR_HEIGHT = 800;
 const char *vertexShaderSource = "#version 330 core\n"
 "layout (location = 0) in vec3 aPos;\n"
 "layout (location = 1) in vec3 viColor;\n"
+"layout (location = 3) in uint drawIndex;\n"
 "\n"
 "out vec3 vColor;\n"
 "\n"
 "uniform mat4 model;\n"
 "uniform mat4 view;\n"
 "uniform mat4 projection;\n"
+"uniform bool batched;\n"
+"uniform samplerBuffer transforms;\n"
 "void main()\n"
 "{\n"
-"       gl_Position = projection * view * model * vec4(aPos, 1.0);\n"
+"       mat4 world = model;\n"
+"       if (batched) {\n"
+"               int base = int(drawIndex) * 4;\n"
+"               world = mat4(texelFetch(transforms, base), texelFetch(transforms, base + 1), texelFetch(transforms, base + 2), texelFetch(transforms, base + 3));\n"
+"       }\n"
+"       gl_Position = projection * view * world * vec4(aPos, 1.0);\n"
 "       vColor = viColor;\n"
 "}\n";
 
@@ -140,19 +150,30 @@ int main()
 
 //	std::vector<float> 
 	
-	unsigned int cubeVAO, cubeVBO, cubeEBO;
-	HW4::bind(cubeVertices, cubeVAO, cubeVBO);
-	HW4::bindEBO(cubeIndices, cubeVAO, cubeEBO);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+	// the cube's vertices and indices are sub-allocated from one shared buffer pool
+	Pool::BufferPool bufferPool;
+	unsigned int cubeVAO = 0;
+	Pool::Range cubeVertexRange, cubeIndexRange;
+	HW4::bind(bufferPool, cubeVertices, cubeVAO, cubeVertexRange);
+	HW4::bindEBO(bufferPool, cubeIndices, cubeVAO, cubeIndexRange);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)cubeVertexRange.offset);
 	glEnableVertexAttribArray(0);
 
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(cubeVertexRange.offset + 3 * sizeof(float)));
 	glEnableVertexAttribArray(1);
 
 	// as we only have a single shader, we could also just activate our shader once beforehand if we want to 
 	glUseProgram(shaderProgram);
 
+	// the bonus mode draws both cubes through one batch: per-draw transforms come from a texture buffer on unit 3
+	Batch::DrawBatch cubeBatch;
+	cubeBatch.create((GLADloadproc)glfwGetProcAddress, 3);
+	int cubeMesh = cubeBatch.addMesh(cubeVertices.data(), (int)cubeVertices.size() / 6, 6 * sizeof(float), cubeIndices.data(), GL_UNSIGNED_INT, (int)cubeIndices.size());
+	cubeBatch.upload<Layout::VertexLayout<Layout::Float<3>, Layout::Float<3>>>();
+	glUniform1i(glGetUniformLocation(shaderProgram, "transforms"), 3);
+	unsigned int batchedLoc = glGetUniformLocation(shaderProgram, "batched");
+
 	enum Homework_number {
 		B1, B2, B3, B4, O1
 	};
@@ -236,7 +257,7 @@ int main()
 			
 			glBindVertexArray(cubeVAO);
 			
-			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)cubeIndexRange.offset);
 		}
 		else if (HW_choose == B2) {
 			model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
@@ -256,7 +277,7 @@ int main()
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 			
 			glBindVertexArray(cubeVAO);
-			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)cubeIndexRange.offset);
 		}
 		else if (HW_choose == B3) {
 			model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
@@ -274,7 +295,7 @@ int main()
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 			glBindVertexArray(cubeVAO);
-			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)cubeIndexRange.offset);
 		}
 		else if (HW_choose == B4) {
 			model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
@@ -296,7 +317,7 @@ int main()
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 			glBindVertexArray(cubeVAO);
-			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)cubeIndexRange.offset);
 		}
 		else {
 			model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
@@ -310,30 +331,25 @@ int main()
 
 			// transform ...
 			
-			glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
 			glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
 			glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
 
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-			glBindVertexArray(cubeVAO);
-			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+			cubeBatch.begin();
+			cubeBatch.draw(cubeMesh, model);
 
 			model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-			view = glm::mat4(1.0f);
-			projection = glm::mat4(1.0f);
 
 			model = glm::rotate(model, 0.5f, glm::vec3(1.0f, 0.0f, 1.0f));
 			model = glm::scale(model, glm::vec3(0.2f, 0.2f, 0.2f));
 			model = glm::translate(model, glm::vec3(sin((float)glfwGetTime()) * 20, 0.0f, cos((float)glfwGetTime()) * 20));
-			view = glm::translate(view, glm::vec3(0.0f, 0.0f, -15.0f));
-			projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
 
-			glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-			glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-			glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(projection));
-			
-			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+			// both cubes share the mesh, so this is a single instanced (or multi-draw) call
+			cubeBatch.draw(cubeMesh, model);
+			glUniform1i(batchedLoc, 1);
+			cubeBatch.submit();
+			glUniform1i(batchedLoc, 0);
 		}
 
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -348,7 +364,8 @@ int main()
 	// ------------------------------------------------------------------------
 
 	glDeleteVertexArrays(1, &cubeVAO);
-	glDeleteBuffers(1, &cubeVBO);
+	cubeBatch.destroy();
+	bufferPool.destroy();
 	// glfw: terminate, clearing all previously allocated GLFW resources.
 	// ------------------------------------------------------------------
 	glfwTerminate();
@@ -6,6 +6,7 @@
 #include <vector>
 #include <glad/glad.h>
 #include "mUtils.h"
+#include "BufferPool.h"
 
 namespace HW4 {
 
@@ -16,21 +17,23 @@ namespace HW4 {
 
 	
 
-	// VAO
-	void bind(vector<float>& data, GLuint& VAO, GLuint& VBO) {
-		glGenVertexArrays(1, &VAO);
-		glGenBuffers(1, &VBO);
+	// VAOڻrangeУrangeΪʱ䣬ٴεʱԭظ
+	// ֮glVertexAttribPointerʱƫҪrange.offsetdatafloatõֽ
+	template<typename T>
+	void bind(Pool::BufferPool& pool, vector<T>& data, GLuint& VAO, Pool::Range& range) {
+		if (!VAO) glGenVertexArrays(1, &VAO);
+		pool.update(range, data);
 		glBindVertexArray(VAO);
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * data.size(), data.data(), GL_DYNAMIC_DRAW);		
+		glBindBuffer(GL_ARRAY_BUFFER, range.buffer);
 	}
 
-	// VAO
-	void bindEBO(vector<unsigned int>& indices, GLuint& VAO, GLuint& EBO) {
-		glGenBuffers(1, &EBO);
+	// EBOͬڻglDrawElementsһ(void*)range.offset
+	// indicesunsigned intunsigned shortMesh::IndexBufferõֽ
+	template<typename T>
+	void bindEBO(Pool::BufferPool& pool, vector<T>& indices, GLuint& VAO, Pool::Range& range) {
+		pool.update(range, indices);
 		glBindVertexArray(VAO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indices.size(), indices.data(), GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, range.buffer);
 	}
 }
 
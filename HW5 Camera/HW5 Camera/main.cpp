@@ -153,14 +153,17 @@ int main()
 		2, 3, 7,    2, 6, 7
 	};
 
-	unsigned int cubeVAO, cubeVBO, cubeEBO;
-	HW4::bind(cubeVertices, cubeVAO, cubeVBO);
-	HW4::bindEBO(cubeIndices, cubeVAO, cubeEBO);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+	// the cube's vertices and indices are sub-allocated from one shared buffer pool
+	Pool::BufferPool bufferPool;
+	unsigned int cubeVAO = 0;
+	Pool::Range cubeVertexRange, cubeIndexRange;
+	HW4::bind(bufferPool, cubeVertices, cubeVAO, cubeVertexRange);
+	HW4::bindEBO(bufferPool, cubeIndices, cubeVAO, cubeIndexRange);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)cubeVertexRange.offset);
 	glEnableVertexAttribArray(0);
 
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(cubeVertexRange.offset + 3 * sizeof(float)));
 	glEnableVertexAttribArray(1);
 
 	// as we only have a single shader, we could also just activate our shader once beforehand if we want to 
@@ -245,7 +248,7 @@ int main()
 			
 			glBindVertexArray(cubeVAO);
 			
-			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)cubeIndexRange.offset);
 		}
 		else if (HW_choose == B2) {
 			model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
@@ -269,7 +272,7 @@ int main()
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 			
 			glBindVertexArray(cubeVAO);
-			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)cubeIndexRange.offset);
 		}
 		else {
 			glfwSetCursorPosCallback(window, mouse_callback);
@@ -294,7 +297,7 @@ int main()
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 			glBindVertexArray(cubeVAO);
-			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)cubeIndexRange.offset);
 		}
 
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -309,7 +312,7 @@ int main()
 	// ------------------------------------------------------------------------
 
 	glDeleteVertexArrays(1, &cubeVAO);
-	glDeleteBuffers(1, &cubeVBO);
+	bufferPool.destroy();
 	// glfw: terminate, clearing all previously allocated GLFW resources.
 	// ------------------------------------------------------------------
 	glfwTerminate();
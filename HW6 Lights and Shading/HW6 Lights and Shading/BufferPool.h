@@ -0,0 +1,148 @@
+#pragma once
+#ifndef _BUFFER_POOL_H_
+#define _BUFFER_POOL_H_
+
+#include <vector>
+#include <cstddef>
+#include <glad/glad.h>
+
+namespace Pool {
+
+	using std::vector;
+
+	// һΣsizeΪܷµֽСʵݣ
+	struct Range {
+		GLuint buffer = 0;
+		GLintptr offset = 0;
+		GLsizeiptr size = 0;
+		int block = -1;
+	};
+
+	// Ӽ󻺳зСΣԷ
+	// ûкʵĿжʱ¿һ飬ÿһͷŵĶΰƫƺϲؿб
+	// ϴͳһGL_COPY_WRITE_BUFFERĶǰVAOϰ󶨵EBO
+	class BufferPool {
+	public:
+		explicit BufferPool(GLsizeiptr firstBlock = 1 << 20, GLsizeiptr alignment_ = 16)
+			: nextSize(firstBlock), alignment(alignment_) {}
+
+		~BufferPool() {
+			destroy();
+		}
+
+		Range allocate(GLsizeiptr bytes) {
+			bytes = roundUp(bytes > 0 ? bytes : 1);
+			for (int b = 0; b < (int)blocks.size(); b++) {
+				Range r;
+				if (take(b, bytes, r)) return r;
+			}
+			Block block;
+			block.size = nextSize > bytes ? nextSize : bytes;
+			nextSize = block.size * 2;
+			glGenBuffers(1, &block.buffer);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, block.buffer);
+			glBufferData(GL_COPY_WRITE_BUFFER, block.size, NULL, GL_DYNAMIC_DRAW);
+			block.free.push_back(Span{ 0, block.size });
+			blocks.push_back(block);
+			Range r;
+			take((int)blocks.size() - 1, bytes, r);
+			return r;
+		}
+
+		// 黹һΣǰڵĿжκϲ
+		void release(Range& r) {
+			if (r.block < 0 || r.block >= (int)blocks.size()) return;
+			vector<Span>& spans = blocks[r.block].free;
+			size_t i = 0;
+			while (i < spans.size() && spans[i].offset < r.offset) i++;
+			spans.insert(spans.begin() + i, Span{ r.offset, r.size });
+			if (i + 1 < spans.size() && spans[i].offset + spans[i].size == spans[i + 1].offset) {
+				spans[i].size += spans[i + 1].size;
+				spans.erase(spans.begin() + i + 1);
+			}
+			if (i > 0 && spans[i - 1].offset + spans[i - 1].size == spans[i].offset) {
+				spans[i - 1].size += spans[i].size;
+				spans.erase(spans.begin() + i);
+			}
+			r = Range();
+		}
+
+		// ŵ¾ԭglBufferSubDataһµģtrueʾbufferoffsetˣ
+		// ÷ҪVAO
+		bool update(Range& r, const void* data, GLsizeiptr bytes) {
+			bool moved = false;
+			if (r.block < 0 || r.size < bytes) {
+				release(r);
+				r = allocate(bytes);
+				moved = true;
+			}
+			if (bytes > 0) {
+				glBindBuffer(GL_COPY_WRITE_BUFFER, r.buffer);
+				glBufferSubData(GL_COPY_WRITE_BUFFER, r.offset, bytes, data);
+			}
+			return moved;
+		}
+
+		template<typename T>
+		bool update(Range& r, const vector<T>& data) {
+			return update(r, data.data(), (GLsizeiptr)(sizeof(T) * data.size()));
+		}
+
+		void destroy() {
+			for (auto& b : blocks) glDeleteBuffers(1, &b.buffer);
+			blocks.clear();
+		}
+
+		int blockCount() const {
+			return (int)blocks.size();
+		}
+
+		// пֽ
+		GLsizeiptr capacity() const {
+			GLsizeiptr total = 0;
+			for (auto& b : blocks) total += b.size;
+			return total;
+		}
+
+	private:
+		struct Span {
+			GLintptr offset;
+			GLsizeiptr size;
+		};
+
+		struct Block {
+			GLuint buffer = 0;
+			GLsizeiptr size = 0;
+			vector<Span> free;    // ƫź
+		};
+
+		vector<Block> blocks;
+		GLsizeiptr nextSize, alignment;
+
+		BufferPool(const BufferPool&);
+		BufferPool& operator=(const BufferPool&);
+
+		GLsizeiptr roundUp(GLsizeiptr bytes) const {
+			return (bytes + alignment - 1) / alignment * alignment;
+		}
+
+		// ڵbҵһĿж
+		bool take(int b, GLsizeiptr bytes, Range& r) {
+			vector<Span>& spans = blocks[b].free;
+			for (size_t i = 0; i < spans.size(); i++) {
+				if (spans[i].size < bytes) continue;
+				r.buffer = blocks[b].buffer;
+				r.offset = spans[i].offset;
+				r.size = bytes;
+				r.block = b;
+				spans[i].offset += bytes;
+				spans[i].size -= bytes;
+				if (spans[i].size == 0) spans.erase(spans.begin() + i);
+				return true;
+			}
+			return false;
+		}
+	};
+}
+
+#endif
@@ -5,6 +5,8 @@
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include "HW4.h"
+#include "VertexLayout.h"
+#include "MeshOptimize.h"
 #include <iostream>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -112,14 +114,20 @@ int main()
 		-0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f
 	};
 	
-	unsigned int cubeVAO, cubeVBO;
-	HW4::bind(cubeVertices, cubeVAO, cubeVBO);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-	glEnableVertexAttribArray(0);
-
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(1);
+	// the cube's vertices and indices are sub-allocated from a shared buffer pool
+	Pool::BufferPool bufferPool;
+	unsigned int cubeVAO = 0;
+	Pool::Range cubeVertexRange, cubeIndexRange;
+	// positions stay float, normals are packed into 10:10:10:2 (16 bytes per vertex instead of 24)
+	typedef Layout::VertexLayout<Layout::Float<3>, Layout::Normal1010102> CubeLayout;
+	std::vector<unsigned char> cubePacked = CubeLayout::pack(cubeVertices);
+	// weld the 36 corners into 24 shared vertices and reorder them for the vertex cache
+	std::vector<unsigned char> cubeMesh;
+	Mesh::IndexBuffer cubeIndices;
+	Mesh::print("cube", Mesh::optimize(cubePacked, CubeLayout::stride, cubeMesh, cubeIndices));
+	HW4::bind(bufferPool, cubeMesh, cubeVAO, cubeVertexRange);
+	CubeLayout::apply(cubeVertexRange.offset);
+	HW4::bindEBO(bufferPool, cubeIndices.data, cubeVAO, cubeIndexRange);
 
 	enum Homework_number {
 		B1, B2
@@ -204,8 +212,7 @@ int main()
 			
 			glBindVertexArray(cubeVAO);
 			
-			//glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-			glDrawArrays(GL_TRIANGLES, 0, 36);
+			glDrawElements(GL_TRIANGLES, cubeIndices.count, cubeIndices.type, (void*)cubeIndexRange.offset);
 		} else {
 			gouraudShader.use();
 
@@ -225,8 +232,7 @@ int main()
 
 			glBindVertexArray(cubeVAO);
 
-			//glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-			glDrawArrays(GL_TRIANGLES, 0, 36);
+			glDrawElements(GL_TRIANGLES, cubeIndices.count, cubeIndices.type, (void*)cubeIndexRange.offset);
 		}
 
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -241,7 +247,7 @@ int main()
 	// ------------------------------------------------------------------------
 
 	glDeleteVertexArrays(1, &cubeVAO);
-	glDeleteBuffers(1, &cubeVBO);
+	bufferPool.destroy();
 	// glfw: terminate, clearing all previously allocated GLFW resources.
 	// ------------------------------------------------------------------
 	glfwTerminate();
@@ -5,6 +5,7 @@
 #include <functional>
 #include <vector>
 #include "mUtils.h"
+#include "BufferPool.h"
 
 namespace Bresenham {
 
@@ -184,13 +185,13 @@ vector<float> genFilledTriPoints(Point p1, Point p2, Point p3) {
 }
 
 // VAO
-void pointsBindVAO(GLuint& VAO, GLuint& VBO, vector<float>& data) {
-	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
+// ڻrangeУrangeΪʱ䣬ٴεʱglBufferSubDataԭظ£Ų²Żһ
+void pointsBindVAO(Pool::BufferPool& pool, GLuint& VAO, Pool::Range& range, vector<float>& data) {
+	if (!VAO) glGenVertexArrays(1, &VAO);
+	pool.update(range, data);
 	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO); 
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * data.size(), data.data(), GL_DYNAMIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+	glBindBuffer(GL_ARRAY_BUFFER, range.buffer);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)range.offset);
 	glEnableVertexAttribArray(0);
 }
 }
@@ -0,0 +1,160 @@
+#pragma once
+#ifndef _GL_HANDLE_H_
+#define _GL_HANDLE_H_
+
+#include <vector>
+#include <utility>
+#include <glad/glad.h>
+
+namespace Resource {
+
+	using std::vector;
+
+	enum Kind {
+		VERTEX_ARRAY,
+		BUFFER,
+		TEXTURE,
+		FRAMEBUFFER,
+		RENDERBUFFER
+	};
+
+	void generate(Kind kind, GLuint* id) {
+		switch (kind) {
+		case VERTEX_ARRAY: glGenVertexArrays(1, id); break;
+		case BUFFER: glGenBuffers(1, id); break;
+		case TEXTURE: glGenTextures(1, id); break;
+		case FRAMEBUFFER: glGenFramebuffers(1, id); break;
+		case RENDERBUFFER: glGenRenderbuffers(1, id); break;
+		}
+	}
+
+	void destroy(Kind kind, GLuint* id) {
+		switch (kind) {
+		case VERTEX_ARRAY: glDeleteVertexArrays(1, id); break;
+		case BUFFER: glDeleteBuffers(1, id); break;
+		case TEXTURE: glDeleteTextures(1, id); break;
+		case FRAMEBUFFER: glDeleteFramebuffers(1, id); break;
+		case RENDERBUFFER: glDeleteRenderbuffers(1, id); break;
+		}
+	}
+
+	// ӳɾУʱֻǼǣÿ֡ĩһ֡ǼǵĶͬһfenceһ
+	// fenceɣGPUѾִǵɾ
+	class DeletionQueue {
+	public:
+		void push(Kind kind, GLuint id) {
+			pending.push_back(std::make_pair(kind, id));
+		}
+
+		// ÿ֡swap֮
+		void endFrame() {
+			if (!pending.empty()) {
+				Batch batch;
+				batch.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+				batch.items.swap(pending);
+				batches.push_back(batch);
+			}
+			size_t done = 0;
+			while (done < batches.size()) {
+				GLenum state = glClientWaitSync(batches[done].fence, 0, 0);
+				if (state != GL_ALREADY_SIGNALED && state != GL_CONDITION_SATISFIED) break;
+				release(batches[done]);
+				done++;
+			}
+			batches.erase(batches.begin(), batches.begin() + done);
+		}
+
+		// ˳ǰglfwTerminate֮ǰãٵȴֱȫɾ
+		void flush() {
+			for (auto& b : batches) release(b);
+			batches.clear();
+			Batch rest;
+			rest.fence = 0;
+			rest.items.swap(pending);
+			release(rest);
+		}
+
+		// ûɾĶ
+		size_t size() const {
+			size_t n = pending.size();
+			for (auto& b : batches) n += b.items.size();
+			return n;
+		}
+
+	private:
+		struct Batch {
+			GLsync fence;
+			vector<std::pair<Kind, GLuint>> items;
+		};
+
+		vector<std::pair<Kind, GLuint>> pending;
+		vector<Batch> batches;
+
+		void release(Batch& b) {
+			for (auto& item : b.items) destroy(item.first, &item.second);
+			if (b.fence) glDeleteSync(b.fence);
+			b.items.clear();
+			b.fence = 0;
+		}
+	};
+
+	// о֮ǰ֤ٺǼǽĶֱӶ
+	DeletionQueue deletionQueue;
+
+	// ֻƶGLresetʱdeletionQueue
+	// ʽתGLuintֱӴglBindXXX
+	template<Kind K>
+	class Handle {
+	public:
+		Handle() {}
+		explicit Handle(GLuint id_) : id(id_) {}
+		Handle(Handle&& other) : id(other.id) {
+			other.id = 0;
+		}
+		~Handle() {
+			reset();
+		}
+
+		Handle& operator=(Handle&& other) {
+			if (this != &other) {
+				reset();
+				id = other.id;
+				other.id = 0;
+			}
+			return *this;
+		}
+
+		static Handle create() {
+			Handle h;
+			generate(K, &h.id);
+			return h;
+		}
+
+		void reset() {
+			if (id) deletionQueue.push(K, id);
+			id = 0;
+		}
+
+		GLuint get() const {
+			return id;
+		}
+
+		operator GLuint() const {
+			return id;
+		}
+
+	private:
+		GLuint id = 0;
+
+		Handle(const Handle&);
+		Handle& operator=(const Handle&);
+	};
+
+	typedef Handle<VERTEX_ARRAY> VertexArray;
+	typedef Handle<BUFFER> Buffer;
+	typedef Handle<TEXTURE> Texture;
+	typedef Handle<FRAMEBUFFER> Framebuffer;
+	typedef Handle<RENDERBUFFER> Renderbuffer;
+}
+
+#endif
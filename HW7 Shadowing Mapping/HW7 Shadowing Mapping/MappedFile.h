@@ -0,0 +1,123 @@
+#pragma once
+#ifndef _MAPPED_FILE_H_
+#define _MAPPED_FILE_H_
+
+#include <cstddef>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace IO {
+
+	// ļС޸ʱ䣬жɵĻǷ
+	bool fileStamp(const char* path, unsigned long long& size, unsigned long long& time) {
+#ifdef _WIN32
+		struct _stat64 st;
+		if (_stat64(path, &st) != 0) return false;
+#else
+		struct stat st;
+		if (stat(path, &st) != 0) return false;
+#endif
+		size = (unsigned long long)st.st_size;
+		time = (unsigned long long)st.st_mtime;
+		return true;
+	}
+
+	// ֻӳļӳڼdata()һֱЧ
+	class MappedFile {
+	public:
+		MappedFile() {}
+		~MappedFile() {
+			close();
+		}
+
+		// ļڻΪʱfalse
+		bool open(const char* path) {
+			close();
+#ifdef _WIN32
+			file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (file == INVALID_HANDLE_VALUE) return false;
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+				close();
+				return false;
+			}
+			bytes = (size_t)size.QuadPart;
+			mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (!mapping) {
+				close();
+				return false;
+			}
+			base = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+			fd = ::open(path, O_RDONLY);
+			if (fd < 0) return false;
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size == 0) {
+				close();
+				return false;
+			}
+			bytes = (size_t)st.st_size;
+			void* p = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+			base = p == MAP_FAILED ? NULL : (const char*)p;
+			if (base) madvise(p, bytes, MADV_SEQUENTIAL);
+#endif
+			if (!base) {
+				close();
+				return false;
+			}
+			return true;
+		}
+
+		void close() {
+#ifdef _WIN32
+			if (base) UnmapViewOfFile(base);
+			if (mapping) CloseHandle(mapping);
+			if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+			mapping = NULL;
+			file = INVALID_HANDLE_VALUE;
+#else
+			if (base) munmap((void*)base, bytes);
+			if (fd >= 0) ::close(fd);
+			fd = -1;
+#endif
+			base = NULL;
+			bytes = 0;
+		}
+
+		bool isOpen() const {
+			return base != NULL;
+		}
+
+		const char* data() const {
+			return base;
+		}
+
+		size_t size() const {
+			return bytes;
+		}
+
+	private:
+		const char* base = NULL;
+		size_t bytes = 0;
+#ifdef _WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = NULL;
+#else
+		int fd = -1;
+#endif
+
+		MappedFile(const MappedFile&);
+		MappedFile& operator=(const MappedFile&);
+	};
+}
+
+#endif
@@ -0,0 +1,358 @@
+#pragma once
+#ifndef _MESH_CACHE_H_
+#define _MESH_CACHE_H_
+
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <glad/glad.h>
+#include "MappedFile.h"
+#include "MeshOptimize.h"
+
+namespace Cache {
+
+	using std::vector;
+
+	// 񻺴ļʽСˣ
+	//   ļͷ MeshFileHeader
+	//    VertexLayoutõĶ㣬16ֽڶ봦ʼ
+	//    16/32λ16ֽڶ봦ʼ
+	// ѹʱݿԴӳڴֱӴglBufferData
+	// ѹʱ㰴ֽͨٶ0γ̱룬ֺzigzag䳤룬ʱȽ
+	const char MESH_FILE_MAGIC[4] = { 'M', 'E', 'S', 'H' };
+	const uint32_t MESH_FILE_VERSION = 1;
+	const uint32_t MESH_FILE_COMPRESSED = 1;
+	const uint64_t MESH_FILE_ALIGNMENT = 16;
+
+	struct MeshFileHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t stride;
+		uint32_t layout;          // VertexLayout::signature()
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t indexType;       // GL_UNSIGNED_SHORTGL_UNSIGNED_INT
+		uint32_t flags;
+		uint64_t sourceSize;      // ԴļĴС޸ʱ䣬һʱ
+		uint64_t sourceTime;
+		float boundsMin[3];
+		float boundsMax[3];
+		float center[3];          // Χ
+		float radius;
+		uint64_t vertexOffset;    // ļͷλ
+		uint64_t vertexBytes;     // ļֽѹʱΪѹĴС
+		uint64_t indexOffset;
+		uint64_t indexBytes;
+	};
+
+	namespace detail {
+
+		uint64_t alignUp(uint64_t x) {
+			return (x + MESH_FILE_ALIGNMENT - 1) / MESH_FILE_ALIGNMENT * MESH_FILE_ALIGNMENT;
+		}
+
+		// ÿֽͨȥһͬһֽڣ0д 0, 
+		void encodeVertices(const unsigned char* vertices, size_t count, int stride, vector<unsigned char>& out) {
+			for (int k = 0; k < stride; k++) {
+				unsigned char prev = 0;
+				size_t i = 0;
+				while (i < count) {
+					unsigned char v = vertices[i * stride + k];
+					unsigned char d = (unsigned char)(v - prev);
+					prev = v;
+					i++;
+					if (d != 0) {
+						out.push_back(d);
+						continue;
+					}
+					unsigned char run = 1;
+					while (i < count && run < 255 && vertices[i * stride + k] == prev) {
+						run++;
+						i++;
+					}
+					out.push_back(0);
+					out.push_back(run);
+				}
+			}
+		}
+
+		bool decodeVertices(const unsigned char* in, size_t bytes, size_t count, int stride, unsigned char* vertices) {
+			const unsigned char* end = in + bytes;
+			for (int k = 0; k < stride; k++) {
+				unsigned char prev = 0;
+				size_t i = 0;
+				while (i < count) {
+					if (in >= end) return false;
+					unsigned char d = *in++;
+					if (d != 0) {
+						prev = (unsigned char)(prev + d);
+						vertices[i++ * stride + k] = prev;
+						continue;
+					}
+					if (in >= end) return false;
+					unsigned char run = *in++;
+					if (run == 0 || run > count - i) return false;
+					for (; run > 0; run--) vertices[i++ * stride + k] = prev;
+				}
+			}
+			return in == end;
+		}
+
+		unsigned int readIndex(const unsigned char* data, GLenum type, size_t i) {
+			if (type == GL_UNSIGNED_SHORT) {
+				unsigned short s;
+				memcpy(&s, data + i * 2, 2);
+				return s;
+			}
+			unsigned int v;
+			memcpy(&v, data + i * 4, 4);
+			return v;
+		}
+
+		// һĲzigzagٰ7λһд
+		void encodeIndices(const unsigned char* data, GLenum type, size_t count, vector<unsigned char>& out) {
+			unsigned int prev = 0;
+			for (size_t i = 0; i < count; i++) {
+				unsigned int v = readIndex(data, type, i);
+				int delta = (int)(v - prev);
+				unsigned int z = ((unsigned int)delta << 1) ^ (unsigned int)(delta >> 31);
+				prev = v;
+				while (z >= 0x80) {
+					out.push_back((unsigned char)(z | 0x80));
+					z >>= 7;
+				}
+				out.push_back((unsigned char)z);
+			}
+		}
+
+		bool decodeIndices(const unsigned char* in, size_t bytes, GLenum type, size_t count, unsigned char* data) {
+			const unsigned char* end = in + bytes;
+			unsigned int prev = 0;
+			for (size_t i = 0; i < count; i++) {
+				unsigned int z = 0;
+				int shift = 0;
+				while (true) {
+					if (in >= end || shift > 28) return false;
+					unsigned char b = *in++;
+					z |= (unsigned int)(b & 0x7F) << shift;
+					shift += 7;
+					if (!(b & 0x80)) break;
+				}
+				int delta = (int)(z >> 1) ^ -(int)(z & 1);
+				prev += (unsigned int)delta;
+				if (type == GL_UNSIGNED_SHORT) {
+					unsigned short s = (unsigned short)prev;
+					memcpy(data + i * 2, &s, 2);
+				}
+				else memcpy(data + i * 4, &prev, 4);
+			}
+			return in == end;
+		}
+
+		bool writeAt(FILE* f, uint64_t& written, uint64_t offset, const void* data, size_t bytes) {
+			static const char zeros[MESH_FILE_ALIGNMENT] = { 0 };
+			if (offset - written > 0 && fwrite(zeros, 1, (size_t)(offset - written), f) != offset - written) return false;
+			written = offset + bytes;
+			return bytes == 0 || fwrite(data, 1, bytes, f) == bytes;
+		}
+	}
+
+	// дļÿ㿪ͷ12ֽΪfloatλãΧУʧܷfalse
+	// sourcePathΪԴļʱݴжϻǷ
+	bool saveMesh(const char* path, const char* sourcePath, int stride, unsigned int layout,
+		const vector<unsigned char>& vertices, const Mesh::IndexBuffer& indices, bool compress = false) {
+		MeshFileHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, MESH_FILE_MAGIC, 4);
+		header.version = MESH_FILE_VERSION;
+		header.stride = (uint32_t)stride;
+		header.layout = layout;
+		header.vertexCount = (uint32_t)(vertices.size() / stride);
+		header.indexCount = (uint32_t)indices.count;
+		header.indexType = indices.type;
+		header.flags = compress ? MESH_FILE_COMPRESSED : 0;
+		unsigned long long size = 0, time = 0;
+		if (sourcePath) IO::fileStamp(sourcePath, size, time);
+		header.sourceSize = size;
+		header.sourceTime = time;
+
+		for (uint32_t i = 0; i < header.vertexCount; i++) {
+			float p[3];
+			memcpy(p, &vertices[(size_t)i * stride], sizeof(p));
+			for (int k = 0; k < 3; k++) {
+				if (i == 0 || p[k] < header.boundsMin[k]) header.boundsMin[k] = p[k];
+				if (i == 0 || p[k] > header.boundsMax[k]) header.boundsMax[k] = p[k];
+			}
+		}
+		float r2 = 0;
+		for (int k = 0; k < 3; k++) header.center[k] = (header.boundsMin[k] + header.boundsMax[k]) * 0.5f;
+		for (uint32_t i = 0; i < header.vertexCount; i++) {
+			float p[3];
+			memcpy(p, &vertices[(size_t)i * stride], sizeof(p));
+			float dx = p[0] - header.center[0], dy = p[1] - header.center[1], dz = p[2] - header.center[2];
+			float d = dx * dx + dy * dy + dz * dz;
+			if (d > r2) r2 = d;
+		}
+		header.radius = std::sqrt(r2);
+
+		const unsigned char* vertexData = vertices.data();
+		const unsigned char* indexData = indices.data.data();
+		header.vertexBytes = vertices.size();
+		header.indexBytes = indices.data.size();
+		vector<unsigned char> packedVertices, packedIndices;
+		if (compress) {
+			detail::encodeVertices(vertices.data(), header.vertexCount, stride, packedVertices);
+			detail::encodeIndices(indices.data.data(), indices.type, indices.count, packedIndices);
+			vertexData = packedVertices.data();
+			indexData = packedIndices.data();
+			header.vertexBytes = packedVertices.size();
+			header.indexBytes = packedIndices.size();
+		}
+		header.vertexOffset = detail::alignUp(sizeof(MeshFileHeader));
+		header.indexOffset = detail::alignUp(header.vertexOffset + header.vertexBytes);
+
+		FILE* f = fopen(path, "wb");
+		if (!f) return false;
+		uint64_t written = 0;
+		bool ok = detail::writeAt(f, written, 0, &header, sizeof(header));
+		ok = ok && detail::writeAt(f, written, header.vertexOffset, vertexData, (size_t)header.vertexBytes);
+		ok = ok && detail::writeAt(f, written, header.indexOffset, indexData, (size_t)header.indexBytes);
+		ok = fclose(f) == 0 && ok;
+		// дһļ£´
+		if (!ok) remove(path);
+		return ok;
+	}
+
+	// ֻӳһ񻺴棬ûѹʱvertexData()/indexData()ֱָӳڴ
+	class MeshFile {
+	public:
+		MeshFile() {}
+
+		// ļͷԡʽͬԴļѸĶʱfalse÷Ӧɻ
+		// sourcePathΪNULLԴļѲʱǷ
+		bool open(const char* path, const char* sourcePath, int stride, unsigned int layout) {
+			close();
+			if (!file.open(path) || !validHeader(stride, layout) || !upToDate(sourcePath) || !decode() || !validIndices()) {
+				close();
+				return false;
+			}
+			return true;
+		}
+
+		void close() {
+			file.close();
+			vertices = indices = NULL;
+			decodedVertices.clear();
+			decodedIndices.clear();
+		}
+
+		bool isOpen() const {
+			return file.isOpen();
+		}
+
+		const MeshFileHeader& header() const {
+			return *(const MeshFileHeader*)file.data();
+		}
+
+		GLsizei vertexCount() const {
+			return (GLsizei)header().vertexCount;
+		}
+
+		GLsizeiptr vertexBytes() const {
+			return (GLsizeiptr)header().vertexCount * header().stride;
+		}
+
+		const void* vertexData() const {
+			return vertices;
+		}
+
+		GLenum indexType() const {
+			return header().indexType;
+		}
+
+		GLsizei indexCount() const {
+			return (GLsizei)header().indexCount;
+		}
+
+		GLsizeiptr indexBytes() const {
+			return (GLsizeiptr)header().indexCount * (header().indexType == GL_UNSIGNED_SHORT ? 2 : 4);
+		}
+
+		const void* indexData() const {
+			return indices;
+		}
+
+		bool compressed() const {
+			return (header().flags & MESH_FILE_COMPRESSED) != 0;
+		}
+
+	private:
+		IO::MappedFile file;
+		const unsigned char* vertices = NULL;
+		const unsigned char* indices = NULL;
+		vector<unsigned char> decodedVertices, decodedIndices;
+
+		MeshFile(const MeshFile&);
+		MeshFile& operator=(const MeshFile&);
+
+		bool validHeader(int stride, unsigned int layout) const {
+			uint64_t bytes = file.size();
+			if (bytes < sizeof(MeshFileHeader)) return false;
+			const MeshFileHeader& h = header();
+			if (memcmp(h.magic, MESH_FILE_MAGIC, 4) != 0 || h.version != MESH_FILE_VERSION) return false;
+			if (h.stride != (uint32_t)stride || h.layout != layout) return false;
+			if (h.indexType != GL_UNSIGNED_SHORT && h.indexType != GL_UNSIGNED_INT) return false;
+			if (h.indexCount % 3 != 0) return false;
+			if (h.vertexOffset % MESH_FILE_ALIGNMENT != 0 || h.indexOffset % MESH_FILE_ALIGNMENT != 0) return false;
+			if (h.vertexOffset > bytes || bytes - h.vertexOffset < h.vertexBytes) return false;
+			if (h.indexOffset > bytes || bytes - h.indexOffset < h.indexBytes) return false;
+			if (h.flags & MESH_FILE_COMPRESSED) return true;
+			return h.vertexBytes == (uint64_t)vertexBytes() && h.indexBytes == (uint64_t)indexBytes();
+		}
+
+		bool upToDate(const char* sourcePath) const {
+			unsigned long long size, time;
+			if (!sourcePath || !IO::fileStamp(sourcePath, size, time)) return true;
+			return header().sourceSize == size && header().sourceTime == time;
+		}
+
+		bool decode() {
+			const MeshFileHeader& h = header();
+			const unsigned char* base = (const unsigned char*)file.data();
+			if (!compressed()) {
+				vertices = base + h.vertexOffset;
+				indices = base + h.indexOffset;
+				return true;
+			}
+			decodedVertices.resize((size_t)vertexBytes());
+			decodedIndices.resize((size_t)indexBytes());
+			if (!detail::decodeVertices(base + h.vertexOffset, (size_t)h.vertexBytes, h.vertexCount, h.stride, decodedVertices.data()))
+				return false;
+			if (!detail::decodeIndices(base + h.indexOffset, (size_t)h.indexBytes, h.indexType, h.indexCount, decodedIndices.data()))
+				return false;
+			vertices = decodedVertices.data();
+			indices = decodedIndices.data();
+			return true;
+		}
+
+		// СԵԽļ𻵻дһ룩ִܾͬغͻƶԽ
+		bool validIndices() const {
+			uint64_t count = header().indexCount, limit = header().vertexCount;
+			if (header().indexType == GL_UNSIGNED_SHORT) {
+				const unsigned short* p = (const unsigned short*)indices;
+				for (uint64_t i = 0; i < count; i++)
+					if (p[i] >= limit) return false;
+			}
+			else {
+				const unsigned int* p = (const unsigned int*)indices;
+				for (uint64_t i = 0; i < count; i++)
+					if (p[i] >= limit) return false;
+			}
+			return true;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,238 @@
+#pragma once
+#ifndef _MESH_OPTIMIZE_H_
+#define _MESH_OPTIMIZE_H_
+
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <iostream>
+#include <glad/glad.h>
+
+namespace Mesh {
+
+	using std::vector;
+
+	// 壬65536ʱ16λ32λ
+	// glDrawElements(GL_TRIANGLES, count, type, ...)
+	struct IndexBuffer {
+		GLenum type = GL_UNSIGNED_INT;
+		GLsizei count = 0;
+		vector<unsigned char> data;
+	};
+
+	// ACMRƽÿҪ任ĶʱΪ3Խӽ0.5Խ
+	struct Report {
+		int inputVertices = 0, uniqueVertices = 0, triangles = 0;
+		float acmrInput = 0, acmrWelded = 0, acmrOptimized = 0;
+	};
+
+	const int CACHE_SIZE = 32;    // ʱģLRUС
+	const int FIFO_SIZE = 16;     // ͳACMRʱģFIFOС
+
+	unsigned int hashBytes(const unsigned char* p, int n) {
+		unsigned int h = 2166136261u;
+		for (int i = 0; i < n; i++) {
+			h ^= p[i];
+			h *= 16777619u;
+		}
+		return h;
+	}
+
+	// ϲֽͬĶ㣬verticesΪcountstrideֽڵĶ
+	// uniqueһγֵ˳򱣴ȥغĶ㣬indices[i]Ϊiԭ±
+	void weld(const unsigned char* vertices, int count, int stride, vector<unsigned char>& unique, vector<unsigned int>& indices) {
+		size_t tableSize = 1;
+		while (tableSize < (size_t)count * 2) tableSize <<= 1;
+		vector<unsigned int> table(tableSize, ~0u);
+		unique.clear();
+		unique.reserve((size_t)count * stride);
+		indices.resize(count);
+		unsigned int next = 0;
+		for (int i = 0; i < count; i++) {
+			const unsigned char* v = vertices + (size_t)i * stride;
+			size_t slot = hashBytes(v, stride) & (tableSize - 1);
+			while (table[slot] != ~0u && memcmp(&unique[(size_t)table[slot] * stride], v, stride) != 0)
+				slot = (slot + 1) & (tableSize - 1);
+			if (table[slot] == ~0u) {
+				table[slot] = next++;
+				unique.insert(unique.end(), v, v + stride);
+			}
+			indices[i] = table[slot];
+		}
+	}
+
+	// FIFOģⶥɫĺ任棬ACMR
+	float acmr(const vector<unsigned int>& indices, int vertexCount, int cacheSize = FIFO_SIZE) {
+		if (indices.size() < 3) return 0.0f;
+		// stampΪ뻺ʱţֽ֮cacheSizeͱȥ
+		vector<unsigned int> stamp(vertexCount, 0);
+		unsigned int time = cacheSize + 1;
+		int misses = 0;
+		for (unsigned int v : indices) {
+			if (time - stamp[v] > (unsigned int)cacheSize) {
+				stamp[v] = time++;
+				misses++;
+			}
+		}
+		return misses / (indices.size() / 3.0f);
+	}
+
+	namespace detail {
+
+		// ForsythĶ֣ù̶ఴڻеλõݼ
+		// ʣԽٵĶӷԽ࣬
+		float vertexScore(int cachePos, int remaining) {
+			if (remaining == 0) return -1.0f;
+			float score = 0.0f;
+			if (cachePos >= 3) score = std::pow(1.0f - (cachePos - 3) / (float)(CACHE_SIZE - 3), 1.5f);
+			else if (cachePos >= 0) score = 0.75f;
+			return score + 2.0f / std::sqrt((float)remaining);
+		}
+	}
+
+	// ڵξûĶ㣨Forsythʱ㷨
+	void optimizeVertexCache(vector<unsigned int>& indices, int vertexCount) {
+		int triCount = (int)(indices.size() / 3);
+		if (triCount == 0) return;
+
+		// ÿ㻹ûΣadjacency[offset[v], offset[v] + remaining[v])
+		vector<int> remaining(vertexCount, 0), offset(vertexCount + 1, 0);
+		for (unsigned int v : indices) remaining[v]++;
+		for (int v = 0; v < vertexCount; v++) offset[v + 1] = offset[v] + remaining[v];
+		vector<int> adjacency(indices.size()), fill(offset.begin(), offset.end() - 1);
+		for (int t = 0; t < triCount; t++)
+			for (int k = 0; k < 3; k++) adjacency[fill[indices[t * 3 + k]]++] = t;
+
+		vector<int> cachePos(vertexCount, -1);
+		vector<float> score(vertexCount);
+		for (int v = 0; v < vertexCount; v++) score[v] = detail::vertexScore(-1, remaining[v]);
+
+		vector<char> emitted(triCount, 0);
+		vector<unsigned int> out;
+		out.reserve(indices.size());
+		vector<unsigned int> cache, next;
+		int best = -1, cursor = 0;
+		for (int n = 0; n < triCount; n++) {
+			// Ķ㶼ûʣˣԭ˳ȡһ
+			if (best < 0) {
+				while (emitted[cursor]) cursor++;
+				best = cursor;
+			}
+			emitted[best] = 1;
+			next.clear();
+			for (int k = 0; k < 3; k++) {
+				unsigned int v = indices[best * 3 + k];
+				out.push_back(v);
+				next.push_back(v);
+				int* tris = &adjacency[offset[v]];
+				for (int i = 0; i < remaining[v]; i++) {
+					if (tris[i] == best) {
+						tris[i] = tris[remaining[v] - 1];
+						break;
+					}
+				}
+				remaining[v]--;
+			}
+			for (unsigned int v : cache)
+				if (v != next[0] && v != next[1] && v != next[2]) next.push_back(v);
+			// ĶҲҪ·
+			for (int i = 0; i < (int)next.size(); i++) {
+				cachePos[next[i]] = i < CACHE_SIZE ? i : -1;
+				score[next[i]] = detail::vertexScore(cachePos[next[i]], remaining[next[i]]);
+			}
+			if ((int)next.size() > CACHE_SIZE) next.resize(CACHE_SIZE);
+			cache.swap(next);
+
+			// ֻڻ涥ڵҷߵ
+			best = -1;
+			float bestScore = -1.0f;
+			for (unsigned int v : cache) {
+				for (int i = 0; i < remaining[v]; i++) {
+					int t = adjacency[offset[v] + i];
+					float s = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+					if (s > bestScore) {
+						bestScore = s;
+						best = t;
+					}
+				}
+			}
+		}
+		indices.swap(out);
+	}
+
+	// һõ˳Ŷ㣬öȡõĶ
+	int optimizeVertexFetch(vector<unsigned char>& vertices, int stride, vector<unsigned int>& indices) {
+		vector<unsigned int> remap(vertices.size() / stride, ~0u);
+		vector<unsigned char> out;
+		out.reserve(vertices.size());
+		unsigned int next = 0;
+		for (unsigned int& v : indices) {
+			if (remap[v] == ~0u) {
+				remap[v] = next++;
+				const unsigned char* src = &vertices[(size_t)v * stride];
+				out.insert(out.end(), src, src + stride);
+			}
+			v = remap[v];
+		}
+		vertices.swap(out);
+		return (int)next;
+	}
+
+	IndexBuffer toIndexBuffer(const vector<unsigned int>& indices, int vertexCount) {
+		IndexBuffer ib;
+		ib.count = (GLsizei)indices.size();
+		if (vertexCount <= 65536) {
+			ib.type = GL_UNSIGNED_SHORT;
+			ib.data.resize(indices.size() * 2);
+			for (size_t i = 0; i < indices.size(); i++) {
+				unsigned short s = (unsigned short)indices[i];
+				memcpy(&ib.data[i * 2], &s, 2);
+			}
+		}
+		else {
+			ib.type = GL_UNSIGNED_INT;
+			ib.data.resize(indices.size() * 4);
+			if (!indices.empty()) memcpy(ib.data.data(), indices.data(), ib.data.size());
+		}
+		return ib;
+	}
+
+	// 񣺰ֽںϲ -> ΰ -> 㰴ȡ˳ -> 16/32λ
+	// verticesΪõĶ㣨VertexLayout::packͬĶҲᱻϲ
+	Report optimize(const vector<unsigned char>& vertices, int stride, const vector<unsigned int>& indices,
+		vector<unsigned char>& outVertices, IndexBuffer& outIndices) {
+		Report r;
+		int count = (int)(vertices.size() / stride);
+		r.inputVertices = count;
+		r.triangles = (int)(indices.size() / 3);
+		r.acmrInput = acmr(indices, count);
+
+		vector<unsigned int> remap;
+		weld(vertices.data(), count, stride, outVertices, remap);
+		vector<unsigned int> welded(indices.size());
+		for (size_t i = 0; i < indices.size(); i++) welded[i] = remap[indices[i]];
+		int unique = (int)(outVertices.size() / stride);
+		r.acmrWelded = acmr(welded, unique);
+
+		optimizeVertexCache(welded, unique);
+		r.uniqueVertices = optimizeVertexFetch(outVertices, stride, welded);
+		r.acmrOptimized = acmr(welded, r.uniqueVertices);
+		outIndices = toIndexBuffer(welded, r.uniqueVertices);
+		return r;
+	}
+
+	// бÿһ
+	Report optimize(const vector<unsigned char>& vertices, int stride, vector<unsigned char>& outVertices, IndexBuffer& outIndices) {
+		vector<unsigned int> indices(vertices.size() / stride);
+		for (size_t i = 0; i < indices.size(); i++) indices[i] = (unsigned int)i;
+		return optimize(vertices, stride, indices, outVertices, outIndices);
+	}
+
+	void print(const char* name, const Report& r) {
+		std::cout << name << ": " << r.inputVertices << " -> " << r.uniqueVertices << " vertices, "
+			<< r.triangles << " triangles, ACMR " << r.acmrInput << " -> " << r.acmrWelded << " (welded) -> "
+			<< r.acmrOptimized << " (optimized)" << std::endl;
+	}
+}
+
+#endif
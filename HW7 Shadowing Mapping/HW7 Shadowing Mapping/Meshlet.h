@@ -0,0 +1,226 @@
+#pragma once
+#ifndef _MESHLET_H_
+#define _MESHLET_H_
+
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "MeshOptimize.h"
+
+namespace Cluster {
+
+	using std::vector;
+
+	// һΣΧμƣģͿռ
+	struct Meshlet {
+		unsigned int firstTriangle, triangleCount;
+		glm::vec3 center;       // Χ
+		float radius;
+		glm::vec3 coneAxis;     // ׶淨coneAxisļнǶconeAngle
+		float coneAngle;        // ȣС90ʱزȫ
+	};
+
+	// ķִؽindices뽨ʱ˳ͬ
+	struct Clusters {
+		vector<Meshlet> meshlets;
+		Mesh::IndexBuffer indices;
+	};
+
+	const int MIN_TRIANGLES = 64;
+	const int MAX_TRIANGLES = 128;
+	const int MAX_VERTICES = 96;
+	// MIN_TRIANGLESκηƽ߼нǵҵһ
+	const float NORMAL_SPLIT_COS = 0.7f;
+
+	namespace detail {
+
+		glm::vec3 position(const unsigned char* vertices, int stride, unsigned int i) {
+			float p[3];
+			memcpy(p, vertices + (size_t)i * stride, sizeof(p));
+			return glm::vec3(p[0], p[1], p[2]);
+		}
+
+		// 淨ߣδһĳΪ
+		glm::vec3 faceNormal(const unsigned char* vertices, int stride, const unsigned int* tri) {
+			glm::vec3 a = position(vertices, stride, tri[0]);
+			glm::vec3 b = position(vertices, stride, tri[1]);
+			glm::vec3 c = position(vertices, stride, tri[2]);
+			return glm::cross(b - a, c - a);
+		}
+
+		// һصİΧͷ׶
+		void bound(const unsigned char* vertices, int stride, const vector<unsigned int>& indices, Meshlet& m) {
+			const unsigned int* tris = &indices[(size_t)m.firstTriangle * 3];
+			glm::vec3 lo = position(vertices, stride, tris[0]), hi = lo;
+			glm::vec3 normalSum(0.0f);
+			for (unsigned int t = 0; t < m.triangleCount; t++) {
+				for (int k = 0; k < 3; k++) {
+					glm::vec3 p = position(vertices, stride, tris[t * 3 + k]);
+					for (int j = 0; j < 3; j++) {
+						if (p[j] < lo[j]) lo[j] = p[j];
+						if (p[j] > hi[j]) hi[j] = p[j];
+					}
+				}
+				glm::vec3 n = faceNormal(vertices, stride, &tris[t * 3]);
+				float len = glm::length(n);
+				if (len > 0) normalSum += n / len;
+			}
+			m.center = (lo + hi) * 0.5f;
+			m.radius = 0.0f;
+			for (unsigned int i = 0; i < m.triangleCount * 3; i++) {
+				float d = glm::length(position(vertices, stride, tris[i]) - m.center);
+				if (d > m.radius) m.radius = d;
+			}
+
+			float sumLength = glm::length(normalSum);
+			m.coneAngle = 3.14159265f;
+			m.coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+			if (sumLength <= 0) return;
+			m.coneAxis = normalSum / sumLength;
+			float minDot = 1.0f;
+			for (unsigned int t = 0; t < m.triangleCount; t++) {
+				glm::vec3 n = faceNormal(vertices, stride, &tris[t * 3]);
+				float len = glm::length(n);
+				if (len <= 0) continue;
+				float d = glm::dot(n / len, m.coneAxis);
+				if (d < minDot) minDot = d;
+			}
+			m.coneAngle = std::acos(minDot < -1.0f ? -1.0f : (minDot > 1.0f ? 1.0f : minDot));
+		}
+
+		// Ӿȡ׶棨Gribb-Hartmann߳ڲһ
+		void frustumPlanes(const glm::mat4& m, glm::vec4 planes[6]) {
+			for (int i = 0; i < 3; i++) {
+				for (int s = 0; s < 2; s++) {
+					float sign = s == 0 ? 1.0f : -1.0f;
+					glm::vec4 p(m[0][3] + sign * m[0][i], m[1][3] + sign * m[1][i], m[2][3] + sign * m[2][i], m[3][3] + sign * m[3][i]);
+					float len = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+					if (len > 0) p = glm::vec4(p.x / len, p.y / len, p.z / len, p.w / len);
+					planes[i * 2 + s] = p;
+				}
+			}
+		}
+
+		bool outside(const glm::vec4 planes[6], const glm::vec3& c, float r) {
+			for (int i = 0; i < 6; i++)
+				if (planes[i].x * c.x + planes[i].y * c.y + planes[i].z * c.z + planes[i].w < -r) return true;
+			return false;
+		}
+
+		// eyeȥζʱtrue
+		// ׶нǡΧŽǡ׶֮Ͳ90ȣһһ淨߼нǶ90
+		bool backfacing(const Meshlet& m, const glm::vec3& eye) {
+			if (m.coneAngle >= 1.5707963f) return false;
+			glm::vec3 d = m.center - eye;
+			float distance = glm::length(d);
+			if (distance <= m.radius) return false;
+			float c = glm::dot(d / distance, m.coneAxis);
+			float view = std::acos(c < -1.0f ? -1.0f : (c > 1.0f ? 1.0f : c));
+			return view + std::asin(m.radius / distance) + m.coneAngle <= 1.5707963f;
+		}
+	}
+
+	// е˳optimizeVertexCacheֲ֮ã̰д
+	// MAX_TRIANGLESλMAX_VERTICESʱMIN_TRIANGLESʱ
+	// زƫϴҲverticesÿ㿪ͷ12ֽΪfloatλ
+	void build(const unsigned char* vertices, int vertexCount, int stride, const Mesh::IndexBuffer& indices, Clusters& out) {
+		out.meshlets.clear();
+		out.indices = indices;
+		vector<unsigned int> tris(indices.count);
+		for (GLsizei i = 0; i < indices.count; i++) {
+			if (indices.type == GL_UNSIGNED_SHORT) {
+				unsigned short s;
+				memcpy(&s, &indices.data[(size_t)i * 2], 2);
+				tris[i] = s;
+			}
+			else memcpy(&tris[i], &indices.data[(size_t)i * 4], 4);
+		}
+
+		// stamp[v] == ǰصı + 1 ʾvڵǰ
+		vector<unsigned int> stamp(vertexCount, 0);
+		const unsigned char* v = vertices;
+		unsigned int triangleCount = (unsigned int)(tris.size() / 3);
+		Meshlet current;
+		current.firstTriangle = current.triangleCount = 0;
+		int used = 0;
+		glm::vec3 normalSum(0.0f);
+		for (unsigned int t = 0; t < triangleCount; t++) {
+			const unsigned int* tri = &tris[t * 3];
+			unsigned int id = (unsigned int)out.meshlets.size() + 1;
+			int fresh = 0;
+			for (int k = 0; k < 3; k++)
+				if (stamp[tri[k]] != id) fresh++;
+			glm::vec3 n = detail::faceNormal(v, stride, tri);
+			float len = glm::length(n);
+			if (len > 0) n /= len;
+
+			bool full = current.triangleCount >= (unsigned int)MAX_TRIANGLES || used + fresh > MAX_VERTICES;
+			if (!full && current.triangleCount >= (unsigned int)MIN_TRIANGLES) {
+				float sumLength = glm::length(normalSum);
+				bool detached = fresh == 3;
+				bool bent = len > 0 && sumLength > 0 && glm::dot(n, normalSum / sumLength) < NORMAL_SPLIT_COS;
+				full = detached || bent;
+			}
+			if (full && current.triangleCount > 0) {
+				detail::bound(v, stride, tris, current);
+				out.meshlets.push_back(current);
+				current.firstTriangle = t;
+				current.triangleCount = 0;
+				used = 0;
+				normalSum = glm::vec3(0.0f);
+				id++;
+			}
+			for (int k = 0; k < 3; k++) {
+				if (stamp[tri[k]] != id) {
+					stamp[tri[k]] = id;
+					used++;
+				}
+			}
+			current.triangleCount++;
+			if (len > 0) normalSum += n;
+		}
+		if (current.triangleCount > 0) {
+			detail::bound(v, stride, tris, current);
+			out.meshlets.push_back(current);
+		}
+	}
+
+	// ޳׶ĴأeyeΪNULLʱ޳رeyeĴأeyeΪ꣩
+	// ɼصοoutڵĿɼغϲһοؿɼ
+	int cull(const Clusters& clusters, const glm::mat4& viewProjection, const glm::mat4& model, const glm::vec3* eye, Mesh::IndexBuffer& out) {
+		glm::vec4 planes[6];
+		detail::frustumPlanes(viewProjection * model, planes);
+		glm::vec3 localEye;
+		if (eye) {
+			glm::vec4 e = glm::inverse(model) * glm::vec4(*eye, 1.0f);
+			localEye = glm::vec3(e.x, e.y, e.z) / e.w;
+		}
+
+		size_t indexSize = clusters.indices.type == GL_UNSIGNED_SHORT ? 2 : 4;
+		out.type = clusters.indices.type;
+		out.data.resize(clusters.indices.data.size());
+		size_t written = 0;
+		int visible = 0;
+		size_t runStart = 0, runEnd = 0;    // ںϲһοɼ
+		for (const Meshlet& m : clusters.meshlets) {
+			if (detail::outside(planes, m.center, m.radius) || (eye && detail::backfacing(m, localEye))) continue;
+			visible++;
+			if (m.firstTriangle != runEnd) {
+				size_t bytes = (runEnd - runStart) * 3 * indexSize;
+				if (bytes) memcpy(&out.data[written], &clusters.indices.data[runStart * 3 * indexSize], bytes);
+				written += bytes;
+				runStart = m.firstTriangle;
+			}
+			runEnd = m.firstTriangle + m.triangleCount;
+		}
+		size_t bytes = (runEnd - runStart) * 3 * indexSize;
+		if (bytes) memcpy(&out.data[written], &clusters.indices.data[runStart * 3 * indexSize], bytes);
+		written += bytes;
+		out.data.resize(written);
+		out.count = (GLsizei)(written / indexSize);
+		return visible;
+	}
+}
+
+#endif
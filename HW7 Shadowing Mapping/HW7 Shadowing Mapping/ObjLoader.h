@@ -0,0 +1,330 @@
+#pragma once
+#ifndef _OBJ_LOADER_H_
+#define _OBJ_LOADER_H_
+
+#include <vector>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include "MappedFile.h"
+
+namespace Obj {
+
+	using std::vector;
+
+	// ÿ8floatλáߡ꣬VertexLayout::packһ
+	// ļûзʱ淨ۼӳƽߣûʱΪ0
+	struct ObjMesh {
+		vector<float> vertices;
+		vector<unsigned int> indices;
+
+		int vertexCount() const {
+			return (int)(vertices.size() / 8);
+		}
+	};
+
+	namespace detail {
+
+		const double POW10[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+			1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		bool isSpace(char c) {
+			return c == ' ' || c == '\t' || c == '\r';
+		}
+
+		const char* skipSpace(const char* p, const char* end) {
+			while (p < end && isSpace(*p)) p++;
+			return p;
+		}
+
+		//  [-+]digits[.digits][e[-+]digits]strtodܶ࣬localeinf/nan
+		// Чֻȡǰ19λ㹻float
+		const char* parseFloat(const char* p, const char* end, float& out) {
+			p = skipSpace(p, end);
+			bool negative = false;
+			if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+			unsigned long long mantissa = 0;
+			int digits = 0, exponent = 0;
+			for (; p < end && *p >= '0' && *p <= '9'; p++) {
+				if (digits < 19) {
+					mantissa = mantissa * 10 + (*p - '0');
+					if (mantissa) digits++;
+				}
+				else exponent++;
+			}
+			if (p < end && *p == '.') {
+				for (p++; p < end && *p >= '0' && *p <= '9'; p++) {
+					if (digits < 19) {
+						mantissa = mantissa * 10 + (*p - '0');
+						if (mantissa) digits++;
+						exponent--;
+					}
+				}
+			}
+			if (p < end && (*p == 'e' || *p == 'E')) {
+				p++;
+				bool negativeExp = false;
+				if (p < end && (*p == '-' || *p == '+')) negativeExp = *p++ == '-';
+				int e = 0;
+				for (; p < end && *p >= '0' && *p <= '9'; p++)
+					if (e < 10000) e = e * 10 + (*p - '0');
+				exponent += negativeExp ? -e : e;
+			}
+			double value = (double)mantissa;
+			if (exponent < 0) value = exponent >= -22 ? value / POW10[-exponent] : value * std::pow(10.0, exponent);
+			else if (exponent > 0) value = exponent <= 22 ? value * POW10[exponent] : value * std::pow(10.0, exponent);
+			out = (float)(negative ? -value : value);
+			return p;
+		}
+
+		const char* parseInt(const char* p, const char* end, int& out) {
+			bool negative = false;
+			if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+			int value = 0;
+			for (; p < end && *p >= '0' && *p <= '9'; p++) value = value * 10 + (*p - '0');
+			out = negative ? -value : value;
+			return p;
+		}
+
+		// һǣv/vt/vn0ʼ-1ʾû
+		// ԣڷֿʱֻλãlocalļҪϿƫ
+		struct Corner {
+			int v, vt, vn;
+			unsigned char local;
+		};
+
+		// һֿĽѰβ
+		struct Chunk {
+			vector<float> positions, texcoords, normals;
+			vector<Corner> corners;
+			bool failed = false;
+		};
+
+		// OBJ1ʼת0ʼcountΪĿǰĸ
+		int resolve(int index, int count, unsigned char bit, unsigned char& local) {
+			if (index > 0) return index - 1;
+			if (index < 0) {
+				local |= bit;
+				return count + index;
+			}
+			return -1;
+		}
+
+		const char* nextLine(const char* p, const char* end) {
+			const char* q = (const char*)memchr(p, '\n', end - p);
+			return q ? q + 1 : end;
+		}
+
+		void parseChunk(const char* p, const char* end, Chunk& chunk) {
+			vector<Corner> face;
+			while (p < end) {
+				const char* lineEnd = nextLine(p, end);
+				p = skipSpace(p, lineEnd);
+				if (p + 1 < lineEnd && p[0] == 'v' && isSpace(p[1])) {
+					float x, y, z;
+					p = parseFloat(p + 1, lineEnd, x);
+					p = parseFloat(p, lineEnd, y);
+					p = parseFloat(p, lineEnd, z);
+					chunk.positions.push_back(x);
+					chunk.positions.push_back(y);
+					chunk.positions.push_back(z);
+				}
+				else if (p + 2 < lineEnd && p[0] == 'v' && p[1] == 't' && isSpace(p[2])) {
+					float u, v;
+					p = parseFloat(p + 2, lineEnd, u);
+					p = parseFloat(p, lineEnd, v);
+					chunk.texcoords.push_back(u);
+					chunk.texcoords.push_back(v);
+				}
+				else if (p + 2 < lineEnd && p[0] == 'v' && p[1] == 'n' && isSpace(p[2])) {
+					float x, y, z;
+					p = parseFloat(p + 2, lineEnd, x);
+					p = parseFloat(p, lineEnd, y);
+					p = parseFloat(p, lineEnd, z);
+					chunk.normals.push_back(x);
+					chunk.normals.push_back(y);
+					chunk.normals.push_back(z);
+				}
+				else if (p + 1 < lineEnd && p[0] == 'f' && isSpace(p[1])) {
+					face.clear();
+					p = skipSpace(p + 1, lineEnd);
+					while (p < lineEnd && *p != '\n' && *p != '#') {
+						Corner c = { -1, -1, -1, 0 };
+						int index = 0;
+						p = parseInt(p, lineEnd, index);
+						c.v = resolve(index, (int)chunk.positions.size() / 3, 1, c.local);
+						if (p < lineEnd && *p == '/') {
+							p++;
+							if (p < lineEnd && *p != '/') {
+								p = parseInt(p, lineEnd, index);
+								c.vt = resolve(index, (int)chunk.texcoords.size() / 2, 2, c.local);
+							}
+							if (p < lineEnd && *p == '/') {
+								p = parseInt(p + 1, lineEnd, index);
+								c.vn = resolve(index, (int)chunk.normals.size() / 3, 4, c.local);
+							}
+						}
+						if (c.v < 0 && !(c.local & 1)) {
+							chunk.failed = true;
+							return;
+						}
+						face.push_back(c);
+						// ֺܲķǷַ
+						while (p < lineEnd && !isSpace(*p) && *p != '\n') p++;
+						p = skipSpace(p, lineEnd);
+					}
+					for (size_t i = 2; i < face.size(); i++) {
+						chunk.corners.push_back(face[0]);
+						chunk.corners.push_back(face[i - 1]);
+						chunk.corners.push_back(face[i]);
+					}
+				}
+				// Уע͡o/g/s/usemtl/mtllibȣ
+				p = lineEnd;
+			}
+		}
+
+		// (v, vt, vn)ϲĹϣ
+		struct CornerTable {
+			vector<Corner> keys;
+			vector<unsigned int> values;
+			size_t mask;
+
+			explicit CornerTable(size_t expected) {
+				size_t size = 16;
+				while (size < expected * 2) size <<= 1;
+				keys.assign(size, Corner{ -2, 0, 0, 0 });
+				values.resize(size);
+				mask = size - 1;
+			}
+
+			// ҵбţnextnext
+			unsigned int insert(const Corner& c, unsigned int next) {
+				size_t h = ((size_t)(unsigned)c.v * 73856093u) ^ ((size_t)(unsigned)c.vt * 19349663u) ^ ((size_t)(unsigned)c.vn * 83492791u);
+				size_t slot = h & mask;
+				while (keys[slot].v != -2) {
+					if (keys[slot].v == c.v && keys[slot].vt == c.vt && keys[slot].vn == c.vn) return values[slot];
+					slot = (slot + 1) & mask;
+				}
+				keys[slot] = c;
+				values[slot] = next;
+				return next;
+			}
+		};
+	}
+
+	// һWavefront OBJļֻv/vt/vn/fʧܷfalse
+	// ļӳгthreads鲢нthreadsΪ0ʱʹȫģ(v, vt, vn)ϲ
+	bool loadObj(const char* path, ObjMesh& mesh, unsigned threads = 0) {
+		using namespace detail;
+		mesh.vertices.clear();
+		mesh.indices.clear();
+		IO::MappedFile file;
+		if (!file.open(path)) return false;
+		const char* begin = file.data();
+		const char* end = begin + file.size();
+
+		if (threads == 0) threads = (std::max)(1u, std::thread::hardware_concurrency());
+		// Сļ̷߳
+		if (file.size() < (1 << 20)) threads = 1;
+
+		// ı߽Ųһпͷ֤ÿֻһ
+		vector<const char*> cuts(1, begin);
+		for (unsigned i = 1; i < threads; i++) {
+			const char* cut = begin + file.size() / threads * i;
+			cut = cut <= cuts.back() ? cuts.back() : nextLine(cut, end);
+			cuts.push_back(cut);
+		}
+		cuts.push_back(end);
+
+		vector<Chunk> chunks(threads);
+		if (threads == 1) parseChunk(begin, end, chunks[0]);
+		else {
+			vector<std::thread> workers;
+			for (unsigned i = 0; i < threads; i++)
+				workers.emplace_back(parseChunk, cuts[i], cuts[i + 1], std::ref(chunks[i]));
+			for (auto& w : workers) w.join();
+		}
+
+		// ƴӸԣѿȫ
+		vector<float> positions, texcoords, normals;
+		size_t cornerCount = 0;
+		for (auto& c : chunks) {
+			if (c.failed) return false;
+			cornerCount += c.corners.size();
+		}
+		vector<Corner> corners;
+		corners.reserve(cornerCount);
+		for (auto& c : chunks) {
+			int vBase = (int)positions.size() / 3, vtBase = (int)texcoords.size() / 2, vnBase = (int)normals.size() / 3;
+			positions.insert(positions.end(), c.positions.begin(), c.positions.end());
+			texcoords.insert(texcoords.end(), c.texcoords.begin(), c.texcoords.end());
+			normals.insert(normals.end(), c.normals.begin(), c.normals.end());
+			for (Corner k : c.corners) {
+				if (k.local & 1) k.v += vBase;
+				if (k.local & 2) k.vt += vtBase;
+				if (k.local & 4) k.vn += vnBase;
+				k.local = 0;
+				corners.push_back(k);
+			}
+			c = Chunk();
+		}
+		int positionCount = (int)positions.size() / 3, texcoordCount = (int)texcoords.size() / 2, normalCount = (int)normals.size() / 3;
+		for (Corner& k : corners) {
+			if (k.v < 0 || k.v >= positionCount) return false;
+			if (k.vt >= texcoordCount) k.vt = -1;
+			if (k.vn >= normalCount) k.vn = -1;
+		}
+
+		// ȱߵĽðλۼӵ淨ߣȨ
+		vector<float> smooth;
+		for (size_t i = 0; i < corners.size(); i += 3) {
+			if (corners[i].vn >= 0 && corners[i + 1].vn >= 0 && corners[i + 2].vn >= 0) continue;
+			if (smooth.empty()) smooth.assign(positions.size(), 0.0f);
+			const float* a = &positions[corners[i].v * 3];
+			const float* b = &positions[corners[i + 1].v * 3];
+			const float* c = &positions[corners[i + 2].v * 3];
+			float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+			float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			for (int k = 0; k < 3; k++)
+				for (int j = 0; j < 3; j++) smooth[corners[i + k].v * 3 + j] += n[j];
+		}
+		for (size_t i = 0; i < smooth.size(); i += 3) {
+			float len = std::sqrt(smooth[i] * smooth[i] + smooth[i + 1] * smooth[i + 1] + smooth[i + 2] * smooth[i + 2]);
+			if (len > 0) {
+				smooth[i] /= len;
+				smooth[i + 1] /= len;
+				smooth[i + 2] /= len;
+			}
+		}
+
+		CornerTable table(corners.size());
+		mesh.indices.resize(corners.size());
+		mesh.vertices.reserve(corners.size() * 8);
+		unsigned int next = 0;
+		for (size_t i = 0; i < corners.size(); i++) {
+			const Corner& k = corners[i];
+			unsigned int index = table.insert(k, next);
+			mesh.indices[i] = index;
+			if (index != next) continue;
+			next++;
+			const float* p = &positions[k.v * 3];
+			const float* n = k.vn >= 0 ? &normals[k.vn * 3] : &smooth[k.v * 3];
+			mesh.vertices.insert(mesh.vertices.end(), p, p + 3);
+			mesh.vertices.insert(mesh.vertices.end(), n, n + 3);
+			if (k.vt >= 0) mesh.vertices.insert(mesh.vertices.end(), &texcoords[k.vt * 2], &texcoords[k.vt * 2] + 2);
+			else {
+				mesh.vertices.push_back(0.0f);
+				mesh.vertices.push_back(0.0f);
+			}
+		}
+		return true;
+	}
+}
+
+#endif
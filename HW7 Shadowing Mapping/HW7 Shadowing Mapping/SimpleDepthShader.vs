@@ -1,10 +1,19 @@
 #version 330 core
 layout (location = 0) in vec3 position;
+layout (location = 3) in uint drawIndex;
 
 uniform mat4 lightSpaceMatrix;
 uniform mat4 model;
+// batched draws fetch their model matrix from a texture buffer, 4 texels per matrix
+uniform bool batched;
+uniform samplerBuffer transforms;
 
 void main()
 {
-    gl_Position = lightSpaceMatrix * model * vec4(position, 1.0f);
+    mat4 world = model;
+    if (batched) {
+        int base = int(drawIndex) * 4;
+        world = mat4(texelFetch(transforms, base), texelFetch(transforms, base + 1), texelFetch(transforms, base + 2), texelFetch(transforms, base + 3));
+    }
+    gl_Position = lightSpaceMatrix * world * vec4(position, 1.0f);
 }
\ No newline at end of file
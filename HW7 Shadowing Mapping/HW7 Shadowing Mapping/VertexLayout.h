@@ -0,0 +1,181 @@
+#pragma once
+#ifndef _VERTEX_LAYOUT_H_
+#define _VERTEX_LAYOUT_H_
+
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <glad/glad.h>
+
+namespace Layout {
+
+	using std::vector;
+
+	// floatת뾫ȣͽ뵽ż
+	unsigned short toHalf(float f) {
+		unsigned int x;
+		memcpy(&x, &f, sizeof(x));
+		unsigned int sign = (x >> 16) & 0x8000;
+		unsigned int mant = x & 0x7FFFFF;
+		int exp = (int)((x >> 23) & 0xFF) - 127 + 15;
+		if (((x >> 23) & 0xFF) == 0xFF) return (unsigned short)(sign | 0x7C00 | (mant ? 0x200 : 0));
+		if (exp >= 31) return (unsigned short)(sign | 0x7C00);
+		if (exp <= 0) {
+			// ǹ
+			if (exp < -10) return (unsigned short)sign;
+			mant |= 0x800000;
+			int shift = 14 - exp;
+			unsigned int h = mant >> shift;
+			unsigned int rest = mant & ((1u << shift) - 1), half = 1u << (shift - 1);
+			if (rest > half || (rest == half && (h & 1))) h++;
+			return (unsigned short)(sign | h);
+		}
+		unsigned int h = ((unsigned int)exp << 10) | (mant >> 13);
+		unsigned int rest = mant & 0x1FFF;
+		// λָλʱһָ
+		if (rest > 0x1000 || (rest == 0x1000 && (h & 1))) h++;
+		return (unsigned short)(sign | h);
+	}
+
+	// ÿ˵count/type/normalizedglVertexAttribPointer
+	// inputsΪԴռfloatsizeΪֽ뵽4ֽڣ
+
+	// ԭ32λfloat
+	template<int N>
+	struct Float {
+		static const GLint count = N;
+		static const GLenum type = GL_FLOAT;
+		static const GLboolean normalized = GL_FALSE;
+		static const int inputs = N, size = 4 * N;
+
+		static void pack(const float* in, unsigned char* out) {
+			memcpy(out, in, 4 * N);
+		}
+	};
+
+	// 뾫ȣʺ
+	template<int N>
+	struct Half {
+		static const GLint count = N;
+		static const GLenum type = GL_HALF_FLOAT;
+		static const GLboolean normalized = GL_FALSE;
+		static const int inputs = N, size = (2 * N + 3) / 4 * 4;
+
+		static void pack(const float* in, unsigned char* out) {
+			for (int i = 0; i < N; i++) {
+				unsigned short h = toHalf(in[i]);
+				memcpy(out + 2 * i, &h, 2);
+			}
+		}
+	};
+
+	// λѹһ32λxyz10λзţwΪ0ɫvec3
+	struct Normal1010102 {
+		static const GLint count = 4;
+		static const GLenum type = GL_INT_2_10_10_10_REV;
+		static const GLboolean normalized = GL_TRUE;
+		static const int inputs = 3, size = 4;
+
+		static void pack(const float* in, unsigned char* out) {
+			unsigned int v = 0;
+			for (int i = 0; i < 3; i++) {
+				float c = in[i] < -1.0f ? -1.0f : (in[i] > 1.0f ? 1.0f : in[i]);
+				int q = (int)std::floor(c * 511.0f + 0.5f);
+				v |= ((unsigned int)q & 0x3FF) << (10 * i);
+			}
+			memcpy(out, &v, 4);
+		}
+	};
+
+	// [0, 1]ɫѹÿ8λ
+	template<int N>
+	struct UNorm8 {
+		static const GLint count = N;
+		static const GLenum type = GL_UNSIGNED_BYTE;
+		static const GLboolean normalized = GL_TRUE;
+		static const int inputs = N, size = (N + 3) / 4 * 4;
+
+		static void pack(const float* in, unsigned char* out) {
+			for (int i = 0; i < N; i++) {
+				float c = in[i] < 0.0f ? 0.0f : (in[i] > 1.0f ? 1.0f : in[i]);
+				out[i] = (unsigned char)std::floor(c * 255.0f + 0.5f);
+			}
+		}
+	};
+
+	namespace detail {
+
+		template<typename... A>
+		struct Sum {
+			static const int size = 0, inputs = 0;
+		};
+
+		template<typename H, typename... T>
+		struct Sum<H, T...> {
+			static const int size = H::size + Sum<T...>::size;
+			static const int inputs = H::inputs + Sum<T...>::inputs;
+		};
+
+		template<int Location, typename... A>
+		struct Each {
+			static void setup(GLsizei, GLintptr) {}
+			static void pack(const float*, unsigned char*) {}
+			static unsigned int signature(unsigned int h) {
+				return h;
+			}
+		};
+
+		template<int Location, typename H, typename... T>
+		struct Each<Location, H, T...> {
+			static void setup(GLsizei stride, GLintptr offset) {
+				glVertexAttribPointer(Location, H::count, H::type, H::normalized, stride, (void*)offset);
+				glEnableVertexAttribArray(Location);
+				Each<Location + 1, T...>::setup(stride, offset + H::size);
+			}
+
+			static void pack(const float* in, unsigned char* out) {
+				H::pack(in, out);
+				Each<Location + 1, T...>::pack(in + H::inputs, out + H::size);
+			}
+
+			static unsigned int signature(unsigned int h) {
+				h = h * 31 + (unsigned int)H::count;
+				h = h * 31 + (unsigned int)H::type;
+				h = h * 31 + (unsigned int)H::normalized;
+				return Each<Location + 1, T...>::signature(h);
+			}
+		};
+	}
+
+	// ʽζӦlocation 0, 1, 2 ...
+	//  VertexLayout<Float<3>, Normal1010102, Half<2>> ÿ20ֽڣȫfloatʱΪ32ֽ
+	template<typename... A>
+	struct VertexLayout {
+		static const int stride = detail::Sum<A...>::size;
+		static const int inputs = detail::Sum<A...>::inputs;
+
+		// ڵǰ󶨵VAOGL_ARRAY_BUFFERԣbaseΪڻʼƫ
+		static void apply(GLintptr base = 0) {
+			detail::Each<0, A...>::setup(stride, base);
+		}
+
+		// ÿinputsfloatĽʽ
+		static vector<unsigned char> pack(const float* src, int count) {
+			vector<unsigned char> out((size_t)count * stride, 0);
+			for (int i = 0; i < count; i++)
+				detail::Each<0, A...>::pack(src + (size_t)i * inputs, &out[(size_t)i * stride]);
+			return out;
+		}
+
+		static vector<unsigned char> pack(const vector<float>& src) {
+			return pack(src.data(), (int)(src.size() / inputs));
+		}
+
+		// ɸԵĸʽıʶдļʽ˻ʧЧ
+		static unsigned int signature() {
+			return detail::Each<0, A...>::signature((unsigned int)stride);
+		}
+	};
+}
+
+#endif
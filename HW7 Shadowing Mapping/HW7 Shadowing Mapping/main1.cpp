@@ -7,6 +7,13 @@
 
 #include "Camera.h"
 #include "shader.h"
+#include "GLHandle.h"
+#include "VertexLayout.h"
+#include "MeshOptimize.h"
+#include "ObjLoader.h"
+#include "MeshCache.h"
+#include "Meshlet.h"
+#include "DrawBatch.h"
 
 #include <iostream>
 
@@ -21,9 +28,13 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow *window);
-unsigned int loadTexture(const char *path);
+Resource::Texture loadTexture(const char *path);
 void renderScene(const Shader &shader);
 void renderCube();
+void renderSceneBatched(const Shader &shader);
+void buildSceneBatch(const float *planeVertices);
+bool loadModel(const char *path);
+void cullModel(const glm::mat4 &viewProjection, const glm::vec3 *eye);
 
 // settings
 const unsigned int SCR_WIDTH = 1280;
@@ -40,7 +51,32 @@ float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
 // meshes
-unsigned int planeVAO;
+// position, normal packed into 10:10:10:2, half-float texture coordinates: 20 bytes per vertex instead of 32
+typedef Layout::VertexLayout<Layout::Float<3>, Layout::Normal1010102, Layout::Half<2>> SceneLayout;
+Resource::VertexArray cubeVAO;
+Resource::Buffer cubeVBO;
+Resource::Buffer cubeEBO;
+Mesh::IndexBuffer cubeIndices;
+Resource::VertexArray planeVAO;
+// optional OBJ model, see loadModel
+Resource::VertexArray modelVAO;
+Resource::Buffer modelVBO;
+Resource::Buffer modelEBO;
+GLenum modelIndexType = GL_UNSIGNED_INT;
+GLsizei modelIndexCount = 0;
+glm::mat4 modelTransform = glm::mat4(1.0f);
+// the model is split into 64-128 triangle clusters, only the visible ones are uploaded each pass
+Cluster::Clusters modelClusters;
+Mesh::IndexBuffer modelVisible;
+bool clusterCulling = true;
+int visibleClusters = 0;
+// smaller cache file, but it has to be decoded instead of uploaded straight from the mapping
+bool compressMeshCache = false;
+// floor and cubes packed into shared buffers and drawn by one multi-draw (or one instanced draw per mesh)
+Batch::DrawBatch sceneBatch;
+int planeMesh = -1, cubeMesh = -1;
+bool batchedDraws = true;
+int batchDrawCalls = 0;
 
 int main() {
 	// glfw: initialize and configure
@@ -99,33 +135,29 @@ int main() {
 		 25.0f, -0.5f, -25.0f,  0.0f, 1.0f, 0.0f,  25.0f, 25.0f
 	};
 	// plane VAO
-	unsigned int planeVBO;
-	glGenVertexArrays(1, &planeVAO);
-	glGenBuffers(1, &planeVBO);
+	planeVAO = Resource::VertexArray::create();
+	Resource::Buffer planeVBO = Resource::Buffer::create();
 	glBindVertexArray(planeVAO);
 	glBindBuffer(GL_ARRAY_BUFFER, planeVBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(planeVertices), planeVertices, GL_STATIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+	std::vector<unsigned char> planePacked = SceneLayout::pack(planeVertices, 6);
+	glBufferData(GL_ARRAY_BUFFER, planePacked.size(), planePacked.data(), GL_STATIC_DRAW);
+	SceneLayout::apply();
 	glBindVertexArray(0);
+	buildSceneBatch(planeVertices);
+	// a model.obj next to the executable is drawn beside the cubes
+	loadModel("model.obj");
 
 	// load textures
 	// -------------
-	unsigned int brickTexture = loadTexture("wood.png");
-	unsigned int boxTexture = loadTexture("wood.png");
+	Resource::Texture brickTexture = loadTexture("wood.png");
+	Resource::Texture boxTexture = loadTexture("wood.png");
 
 	// configure depth map FBO
 	// -----------------------
 	const unsigned int SHADOW_WIDTH = 1024, SHADOW_HEIGHT = 1024;
-	unsigned int depthMapFBO;
-	glGenFramebuffers(1, &depthMapFBO);
+	Resource::Framebuffer depthMapFBO = Resource::Framebuffer::create();
 	// create depth texture
-	unsigned int depthMap;
-	glGenTextures(1, &depthMap);
+	Resource::Texture depthMap = Resource::Texture::create();
 	glBindTexture(GL_TEXTURE_2D, depthMap);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -143,6 +175,9 @@ int main() {
 	shader.use();
 	shader.setInt("diffuseTexture", 0);
 	shader.setInt("shadowMap", 2);
+	shader.setInt("transforms", 3);
+	simpleDepthShader.use();
+	simpleDepthShader.setInt("transforms", 3);
 
 	glm::vec3 lightPos(-2.0f, 4.0f, -1.0f);
 
@@ -189,7 +224,10 @@ int main() {
 		glClear(GL_DEPTH_BUFFER_BIT);
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, brickTexture);
-		renderScene(simpleDepthShader);
+		// clusters facing away from the light still cast shadows, so only the frustum test applies here
+		cullModel(lightSpaceMatrix, NULL);
+		if (batchedDraws) renderSceneBatched(simpleDepthShader);
+		else renderScene(simpleDepthShader);
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
 		// reset viewport
@@ -220,7 +258,9 @@ int main() {
 		glBindTexture(GL_TEXTURE_2D, boxTexture);
 		glActiveTexture(GL_TEXTURE2);
 		glBindTexture(GL_TEXTURE_2D, depthMap);
-		renderScene(shader);
+		cullModel(projection * view, &camera.Position);
+		if (batchedDraws) renderSceneBatched(shader);
+		else renderScene(shader);
 
 		// glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
 		// -------------------------------------------------------------------------------
@@ -230,18 +270,39 @@ int main() {
 		ImGui::NewFrame();
 		ImGui::Begin("hw7");
 		ImGui::SliderFloat3("choose pos of light", glm::value_ptr(lightPos), -10.0f, 10.0f);
+		ImGui::Checkbox("batched draws", &batchedDraws);
+		if (batchedDraws)
+			ImGui::Text("%s: %d draw calls", sceneBatch.indirect() ? "multi-draw indirect" : "instanced", batchDrawCalls);
+		if (modelVAO != 0) {
+			ImGui::Checkbox("cluster culling", &clusterCulling);
+			ImGui::Text("visible clusters: %d / %d", visibleClusters, (int)modelClusters.meshlets.size());
+		}
 		ImGui::End();
 		ImGui::Render();
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
 		glfwSwapBuffers(window);
 		glfwPollEvents();
+		// objects released during this frame are deleted once the GPU has finished with them
+		Resource::deletionQueue.endFrame();
 	}
 
 	// optional: de-allocate all resources once they've outlived their purpose:
 	// ------------------------------------------------------------------------
-	glDeleteVertexArrays(1, &planeVAO);
-	glDeleteBuffers(1, &planeVBO);
+	planeVAO.reset();
+	cubeVAO.reset();
+	cubeVBO.reset();
+	cubeEBO.reset();
+	modelVAO.reset();
+	modelVBO.reset();
+	modelEBO.reset();
+	sceneBatch.destroy();
+	planeVBO.reset();
+	brickTexture.reset();
+	boxTexture.reset();
+	depthMapFBO.reset();
+	depthMap.reset();
+	Resource::deletionQueue.flush();
 
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
@@ -275,77 +336,205 @@ void renderScene(const Shader &shader) {
 	model = glm::scale(model, glm::vec3(0.2f));
 	shader.setMat4("model", model);
 	renderCube();
+	// loaded model
+	if (modelVAO != 0) {
+		shader.setMat4("model", modelTransform);
+		glBindVertexArray(modelVAO);
+		glDrawElements(GL_TRIANGLES, modelIndexCount, modelIndexType, 0);
+		glBindVertexArray(0);
+	}
+}
+
+// position, normal, texture coordinates
+const float cubeVertices[] = {
+	// back face
+	-1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 0.0f, 0.0f, // bottom-left
+	 1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, 1.0f, // top-right
+	 1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, 0.0f, // bottom-right         
+	 1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, 1.0f, // top-right
+	-1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 0.0f, 0.0f, // bottom-left
+	-1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 0.0f, 1.0f, // top-left
+	// front face
+	-1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f, 0.0f, // bottom-left
+	 1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f, 0.0f, // bottom-right
+	 1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f, 1.0f, // top-right
+	 1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f, 1.0f, // top-right
+	-1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f, 1.0f, // top-left
+	-1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f, 0.0f, // bottom-left
+	// left face
+	-1.0f,  1.0f,  1.0f, -1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-right
+	-1.0f,  1.0f, -1.0f, -1.0f,  0.0f,  0.0f, 1.0f, 1.0f, // top-left
+	-1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-left
+	-1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-left
+	-1.0f, -1.0f,  1.0f, -1.0f,  0.0f,  0.0f, 0.0f, 0.0f, // bottom-right
+	-1.0f,  1.0f,  1.0f, -1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-right
+	// right face
+	 1.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-left
+	 1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-right
+	 1.0f,  1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 1.0f, 1.0f, // top-right         
+	 1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-right
+	 1.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-left
+	 1.0f, -1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 0.0f, 0.0f, // bottom-left     
+	// bottom face
+	-1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 0.0f, 1.0f, // top-right
+	 1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 1.0f, 1.0f, // top-left
+	 1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, 1.0f, 0.0f, // bottom-left
+	 1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, 1.0f, 0.0f, // bottom-left
+	-1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, 0.0f, 0.0f, // bottom-right
+	-1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 0.0f, 1.0f, // top-right
+	// top face
+	-1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 0.0f, 1.0f, // top-left
+	 1.0f,  1.0f , 1.0f,  0.0f,  1.0f,  0.0f, 1.0f, 0.0f, // bottom-right
+	 1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 1.0f, 1.0f, // top-right     
+	 1.0f,  1.0f,  1.0f,  0.0f,  1.0f,  0.0f, 1.0f, 0.0f, // bottom-right
+	-1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 0.0f, 1.0f, // top-left
+	-1.0f,  1.0f,  1.0f,  0.0f,  1.0f,  0.0f, 0.0f, 0.0f  // bottom-left        
+};
+
+// same scene as renderScene, but the floor and cubes go through sceneBatch
+// both textures are wood.png, so the floor and cubes sample unit 0 alike
+// the model keeps its own draw because its index buffer is re-culled every pass
+// ------------------------------------------------------------------------------
+void renderSceneBatched(const Shader &shader) {
+	shader.setInt("diffuseTexture", 0);
+	shader.setInt("shadowMap", 2);
+	shader.setBool("batched", true);
+	sceneBatch.begin();
+	sceneBatch.draw(planeMesh, glm::mat4(1.0f));
+	glm::mat4 model = glm::mat4(1.0f);
+	model = glm::translate(model, glm::vec3(0.0f, 1.5f, 0.0f));
+	model = glm::scale(model, glm::vec3(0.5f));
+	sceneBatch.draw(cubeMesh, model);
+	model = glm::mat4(1.0f);
+	model = glm::translate(model, glm::vec3(-1.5f, 2.5f, 0.0f));
+	model = glm::rotate(model, 60.0f, glm::normalize(glm::vec3(1.0, 0.0, 1.0)));
+	model = glm::scale(model, glm::vec3(0.2f));
+	sceneBatch.draw(cubeMesh, model);
+	batchDrawCalls = sceneBatch.submit();
+	shader.setBool("batched", false);
+	if (modelVAO != 0) {
+		shader.setMat4("model", modelTransform);
+		glBindVertexArray(modelVAO);
+		glDrawElements(GL_TRIANGLES, modelIndexCount, modelIndexType, 0);
+		glBindVertexArray(0);
+		batchDrawCalls++;
+	}
 }
 
+// welds the floor and the cube and packs both into sceneBatch
+// multi-draw indirect is used when the driver has it (GL 4.3 or ARB_multi_draw_indirect), instancing otherwise
+// -------------------------------------------------------------------------------------------------------------
+void buildSceneBatch(const float *planeVertices) {
+	sceneBatch.create((GLADloadproc)glfwGetProcAddress, 3);
+	std::vector<unsigned char> mesh;
+	Mesh::IndexBuffer indices;
+	Mesh::optimize(SceneLayout::pack(planeVertices, 6), SceneLayout::stride, mesh, indices);
+	planeMesh = sceneBatch.addMesh(mesh.data(), (int)(mesh.size() / SceneLayout::stride), SceneLayout::stride, indices.data.data(), indices.type, indices.count);
+	Mesh::optimize(SceneLayout::pack(cubeVertices, 36), SceneLayout::stride, mesh, indices);
+	cubeMesh = sceneBatch.addMesh(mesh.data(), (int)(mesh.size() / SceneLayout::stride), SceneLayout::stride, indices.data.data(), indices.type, indices.count);
+	sceneBatch.upload<SceneLayout>();
+	std::cout << "scene batch: " << (sceneBatch.indirect() ? "glMultiDrawElementsIndirect" : "instanced fallback") << std::endl;
+}
 
-unsigned int cubeVAO = 0;
-unsigned int cubeVBO = 0;
 void renderCube() {
 	// initialize (if necessary)
 	if (cubeVAO == 0) {
-		float vertices[] = {
-			// back face
-			-1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 0.0f, 0.0f, // bottom-left
-			 1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, 1.0f, // top-right
-			 1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, 0.0f, // bottom-right         
-			 1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 1.0f, 1.0f, // top-right
-			-1.0f, -1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 0.0f, 0.0f, // bottom-left
-			-1.0f,  1.0f, -1.0f,  0.0f,  0.0f, -1.0f, 0.0f, 1.0f, // top-left
-			// front face
-			-1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f, 0.0f, // bottom-left
-			 1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f, 0.0f, // bottom-right
-			 1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f, 1.0f, // top-right
-			 1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 1.0f, 1.0f, // top-right
-			-1.0f,  1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f, 1.0f, // top-left
-			-1.0f, -1.0f,  1.0f,  0.0f,  0.0f,  1.0f, 0.0f, 0.0f, // bottom-left
-			// left face
-			-1.0f,  1.0f,  1.0f, -1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-right
-			-1.0f,  1.0f, -1.0f, -1.0f,  0.0f,  0.0f, 1.0f, 1.0f, // top-left
-			-1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-left
-			-1.0f, -1.0f, -1.0f, -1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-left
-			-1.0f, -1.0f,  1.0f, -1.0f,  0.0f,  0.0f, 0.0f, 0.0f, // bottom-right
-			-1.0f,  1.0f,  1.0f, -1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-right
-			// right face
-			 1.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-left
-			 1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-right
-			 1.0f,  1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 1.0f, 1.0f, // top-right         
-			 1.0f, -1.0f, -1.0f,  1.0f,  0.0f,  0.0f, 0.0f, 1.0f, // bottom-right
-			 1.0f,  1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 1.0f, 0.0f, // top-left
-			 1.0f, -1.0f,  1.0f,  1.0f,  0.0f,  0.0f, 0.0f, 0.0f, // bottom-left     
-			// bottom face
-			-1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 0.0f, 1.0f, // top-right
-			 1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 1.0f, 1.0f, // top-left
-			 1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, 1.0f, 0.0f, // bottom-left
-			 1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, 1.0f, 0.0f, // bottom-left
-			-1.0f, -1.0f,  1.0f,  0.0f, -1.0f,  0.0f, 0.0f, 0.0f, // bottom-right
-			-1.0f, -1.0f, -1.0f,  0.0f, -1.0f,  0.0f, 0.0f, 1.0f, // top-right
-			// top face
-			-1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 0.0f, 1.0f, // top-left
-			 1.0f,  1.0f , 1.0f,  0.0f,  1.0f,  0.0f, 1.0f, 0.0f, // bottom-right
-			 1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 1.0f, 1.0f, // top-right     
-			 1.0f,  1.0f,  1.0f,  0.0f,  1.0f,  0.0f, 1.0f, 0.0f, // bottom-right
-			-1.0f,  1.0f, -1.0f,  0.0f,  1.0f,  0.0f, 0.0f, 1.0f, // top-left
-			-1.0f,  1.0f,  1.0f,  0.0f,  1.0f,  0.0f, 0.0f, 0.0f  // bottom-left        
-		};
-		glGenVertexArrays(1, &cubeVAO);
-		glGenBuffers(1, &cubeVBO);
+		cubeVAO = Resource::VertexArray::create();
+		cubeVBO = Resource::Buffer::create();
+		cubeEBO = Resource::Buffer::create();
+		// weld the 36 corners into 24 shared vertices and reorder them for the vertex cache
+		std::vector<unsigned char> packed = SceneLayout::pack(cubeVertices, 36), mesh;
+		Mesh::print("cube", Mesh::optimize(packed, SceneLayout::stride, mesh, cubeIndices));
 		// fill buffer
 		glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, mesh.size(), mesh.data(), GL_STATIC_DRAW);
 		// link vertex attributes
 		glBindVertexArray(cubeVAO);
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+		SceneLayout::apply();
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, cubeIndices.data.size(), cubeIndices.data.data(), GL_STATIC_DRAW);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		glBindVertexArray(0);
 	}
 	// render Cube
 	glBindVertexArray(cubeVAO);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
+	glDrawElements(GL_TRIANGLES, cubeIndices.count, cubeIndices.type, 0);
+	glBindVertexArray(0);
+}
+
+// loads a Wavefront OBJ and scales it to a unit box standing on the floor
+// the welded, cache-optimized mesh is kept in <path>.meshcache and reused until the OBJ changes
+// ------------------------------------------------------------------------------------------
+bool loadModel(const char *path) {
+	double start = glfwGetTime();
+	std::string cachePath = std::string(path) + ".meshcache";
+	Cache::MeshFile cache;
+	if (!cache.open(cachePath.c_str(), path, SceneLayout::stride, SceneLayout::signature())) {
+		Obj::ObjMesh mesh;
+		if (!Obj::loadObj(path, mesh) || mesh.indices.empty()) return false;
+		std::vector<unsigned char> packed = SceneLayout::pack(mesh.vertices), welded;
+		Mesh::IndexBuffer indices;
+		Mesh::print(path, Mesh::optimize(packed, SceneLayout::stride, mesh.indices, welded, indices));
+		if (!Cache::saveMesh(cachePath.c_str(), path, SceneLayout::stride, SceneLayout::signature(), welded, indices, compressMeshCache) ||
+			!cache.open(cachePath.c_str(), path, SceneLayout::stride, SceneLayout::signature()))
+			return false;
+		std::cout << path << ": converted to " << cachePath << " in " << (glfwGetTime() - start) * 1000.0 << " ms" << std::endl;
+		start = glfwGetTime();
+	}
+
+	const Cache::MeshFileHeader& header = cache.header();
+	glm::vec3 lo(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+	glm::vec3 hi(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+	glm::vec3 extent = hi - lo;
+	float size = (std::max)(extent.x, (std::max)(extent.y, extent.z));
+	modelTransform = glm::translate(glm::mat4(1.0f), glm::vec3(2.0f, -0.5f, 1.0f));
+	if (size > 0.0f) modelTransform = glm::scale(modelTransform, glm::vec3(1.0f / size));
+	modelTransform = glm::translate(modelTransform, -glm::vec3((lo.x + hi.x) * 0.5f, lo.y, (lo.z + hi.z) * 0.5f));
+
+	// uncompressed caches go from the mapped file straight to the driver
+	modelVAO = Resource::VertexArray::create();
+	modelVBO = Resource::Buffer::create();
+	modelEBO = Resource::Buffer::create();
+	glBindVertexArray(modelVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, modelVBO);
+	glBufferData(GL_ARRAY_BUFFER, cache.vertexBytes(), cache.vertexData(), GL_STATIC_DRAW);
+	SceneLayout::apply();
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, modelEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, cache.indexBytes(), cache.indexData(), GL_STATIC_DRAW);
+	glBindVertexArray(0);
+	modelIndexType = cache.indexType();
+	modelIndexCount = cache.indexCount();
+
+	// keep the indices on the CPU so the visible clusters can be compacted every frame
+	Mesh::IndexBuffer indices;
+	indices.type = cache.indexType();
+	indices.count = cache.indexCount();
+	const unsigned char* indexData = (const unsigned char*)cache.indexData();
+	indices.data.assign(indexData, indexData + cache.indexBytes());
+	Cluster::build((const unsigned char*)cache.vertexData(), cache.vertexCount(), SceneLayout::stride, indices, modelClusters);
+
+	std::cout << cachePath << ": " << cache.vertexCount() << " vertices, " << modelIndexCount / 3 << " triangles loaded in "
+		<< (glfwGetTime() - start) * 1000.0 << " ms, " << modelClusters.meshlets.size() << " clusters" << std::endl;
+	return true;
+}
+
+// culls the model's clusters against viewProjection (and facing away from eye when given)
+// and uploads the compacted indices of the visible ones
+// ---------------------------------------------------------------------------------------
+void cullModel(const glm::mat4 &viewProjection, const glm::vec3 *eye) {
+	if (modelVAO == 0) return;
+	glBindVertexArray(modelVAO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, modelEBO);
+	if (clusterCulling) {
+		visibleClusters = Cluster::cull(modelClusters, viewProjection, modelTransform, eye, modelVisible);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, modelVisible.data.size(), modelVisible.data.data(), GL_STREAM_DRAW);
+		modelIndexCount = modelVisible.count;
+	}
+	else if (modelIndexCount != modelClusters.indices.count) {
+		visibleClusters = (int)modelClusters.meshlets.size();
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, modelClusters.indices.data.size(), modelClusters.indices.data.data(), GL_STATIC_DRAW);
+		modelIndexCount = modelClusters.indices.count;
+	}
 	glBindVertexArray(0);
 }
 
@@ -397,9 +586,8 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
 
 // utility function for loading a 2D texture from file
 // ---------------------------------------------------
-unsigned int loadTexture(char const * path) {
-	unsigned int textureID;
-	glGenTextures(1, &textureID);
+Resource::Texture loadTexture(char const * path) {
+	Resource::Texture textureID = Resource::Texture::create();
 
 	int width, height, nrComponents;
 	unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
@@ -2,6 +2,7 @@
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 normal;
 layout (location = 2) in vec2 texCoords;
+layout (location = 3) in uint drawIndex;
 
 out VS_OUT {
     vec3 FragPos;
@@ -14,12 +15,20 @@ uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 model;
 uniform mat4 lightSpaceMatrix;
+// batched draws fetch their model matrix from a texture buffer, 4 texels per matrix
+uniform bool batched;
+uniform samplerBuffer transforms;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(position, 1.0f);
-    vs_out.FragPos = vec3(model * vec4(position, 1.0));
-    vs_out.Normal = transpose(inverse(mat3(model))) * normal;
+    mat4 world = model;
+    if (batched) {
+        int base = int(drawIndex) * 4;
+        world = mat4(texelFetch(transforms, base), texelFetch(transforms, base + 1), texelFetch(transforms, base + 2), texelFetch(transforms, base + 3));
+    }
+    gl_Position = projection * view * world * vec4(position, 1.0f);
+    vs_out.FragPos = vec3(world * vec4(position, 1.0));
+    vs_out.Normal = transpose(inverse(mat3(world))) * normal;
     vs_out.TexCoords = texCoords;
     vs_out.FragPosLightSpace = lightSpaceMatrix * vec4(vs_out.FragPos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,219 @@
+// Headless benchmark for the Bezier evaluation paths in HW8 Curve.
+// For every degree and sample count it prints ns per sample, heap allocations per call
+// and the max distance to a long double de Casteljau reference.
+// Build in Release; no window or GL context is created.
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "Bezier.h"
+#include "Kernels.h"
+
+// every heap allocation in the process goes through here so each call can be charged
+static long long allocationCount = 0;
+
+void* operator new(size_t size) {
+	allocationCount++;
+	void* p = malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept {
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	free(p);
+}
+
+using Bezier::Point;
+using std::vector;
+
+struct Result {
+	double nsPerSample;
+	double allocsPerCall;
+	double maxError;
+};
+
+// long double de Casteljau, the reference every strategy is compared against
+static void reference(const vector<Point>& ps, long double t, long double& x, long double& y) {
+	vector<long double> xs(ps.size()), ys(ps.size());
+	for (size_t i = 0; i < ps.size(); i++) {
+		xs[i] = ps[i].x;
+		ys[i] = ps[i].y;
+	}
+	for (size_t k = ps.size() - 1; k > 0; k--) {
+		for (size_t i = 0; i < k; i++) {
+			xs[i] = (1 - t) * xs[i] + t * xs[i + 1];
+			ys[i] = (1 - t) * ys[i] + t * ys[i + 1];
+		}
+	}
+	x = xs[0];
+	y = ys[0];
+}
+
+// distance of out[k] (3 floats per point) to the reference at ts[k]
+static double maxError(const vector<Point>& ps, const vector<float>& ts, const float* out) {
+	double worst = 0;
+	for (size_t k = 0; k < ts.size(); k++) {
+		long double x, y;
+		reference(ps, ts[k], x, y);
+		double dx = (double)(x - out[k * 3]), dy = (double)(y - out[k * 3 + 1]);
+		worst = (std::max)(worst, std::sqrt(dx * dx + dy * dy));
+	}
+	return worst;
+}
+
+// runs f until at least 50ms have passed, returns ns per call and allocations per call
+template<typename F>
+static void measure(F f, double& nsPerCall, double& allocsPerCall) {
+	f();   // warm up, also sizes any scratch buffers
+	long long calls = 0;
+	long long allocs = allocationCount;
+	auto start = std::chrono::steady_clock::now();
+	double elapsed = 0;
+	while (elapsed < 5e7) {
+		f();
+		calls++;
+		elapsed = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+	nsPerCall = elapsed / calls;
+	allocsPerCall = (double)(allocationCount - allocs) / calls;
+}
+
+static Result benchBernstein(const vector<Point>& ps, int samples) {
+	int n = (int)ps.size() - 1;
+	vector<float> ts(samples), out((size_t)samples * 3);
+	for (int k = 0; k < samples; k++) ts[k] = (float)k / samples;
+	Result r;
+	double ns;
+	measure([&]() {
+		for (int k = 0; k < samples; k++) {
+			float x = 0, y = 0;
+			for (int i = 0; i <= n; i++) {
+				float b = Bezier::bernstein(i, n, ts[k]);
+				x += b * ps[i].x;
+				y += b * ps[i].y;
+			}
+			out[k * 3] = x;
+			out[k * 3 + 1] = y;
+			out[k * 3 + 2] = 0.0f;
+		}
+	}, ns, r.allocsPerCall);
+	r.nsPerSample = ns / samples;
+	r.maxError = maxError(ps, ts, out.data());
+	return r;
+}
+
+static Result benchDeCasteljau(const vector<Point>& ps, int samples) {
+	vector<float> ts(samples), out((size_t)samples * 3);
+	for (int k = 0; k < samples; k++) ts[k] = (float)k / samples;
+	Bezier::DeCasteljau evaluator;
+	Result r;
+	double ns;
+	measure([&]() {
+		for (int k = 0; k < samples; k++) {
+			Point p = evaluator.eval(ps, ts[k]);
+			out[k * 3] = p.x;
+			out[k * 3 + 1] = p.y;
+			out[k * 3 + 2] = 0.0f;
+		}
+	}, ns, r.allocsPerCall);
+	r.nsPerSample = ns / samples;
+	r.maxError = maxError(ps, ts, out.data());
+	return r;
+}
+
+// degree-specialized kernels, falls back to de Casteljau above degree 5
+static Result benchFixed(const vector<Point>& ps, int samples) {
+	float dt = 1.0f / samples;
+	vector<float> ts(samples), out((size_t)samples * 3);
+	for (int k = 0; k < samples; k++) ts[k] = k * dt;
+	Result r;
+	double ns;
+	measure([&]() {
+		Bezier::sampleRange(ps, 0, samples, dt, out.data());
+	}, ns, r.allocsPerCall);
+	r.nsPerSample = ns / samples;
+	r.maxError = maxError(ps, ts, out.data());
+	return r;
+}
+
+// the whole genBezierCurvePoints call, deltaT is set so it returns about `samples` points
+static Result benchGenCurve(const vector<Point>& ps, int samples) {
+	Bezier::deltaT = 1.0f / samples;
+	vector<float> out;
+	Result r;
+	double ns;
+	measure([&]() {
+		out = Bezier::genBezierCurvePoints(ps, 1.0f);
+	}, ns, r.allocsPerCall);
+	// same accumulated t as the loop inside genBezierCurvePoints
+	vector<float> ts;
+	for (float t = 0; t < 1.0f; t += Bezier::deltaT) ts.push_back(t);
+	r.nsPerSample = ns / (std::max)((size_t)1, out.size() / 3);
+	r.maxError = maxError(ps, ts, out.data());
+	Bezier::deltaT = 0.001f;
+	return r;
+}
+
+// genAssistantLinePoints draws n(n+1)/2 segments per call, reported per segment endpoint
+static Result benchAssistant(const vector<Point>& ps, int) {
+	vector<float> out;
+	Result r;
+	double ns;
+	measure([&]() {
+		out.clear();
+		Bezier::genAssistantLinePoints(ps, 0.37f, out);
+	}, ns, r.allocsPerCall);
+	r.nsPerSample = ns / (std::max)((size_t)1, out.size() / 3);
+	// the last segment's endpoints straddle the curve point, check the lerp between them
+	long double x, y;
+	reference(ps, 0.37f, x, y);
+	size_t m = out.size();
+	double px = out[m - 6] + 0.37 * (out[m - 3] - out[m - 6]);
+	double py = out[m - 5] + 0.37 * (out[m - 2] - out[m - 5]);
+	r.maxError = ps.size() > 2 ? std::sqrt((double)((x - px) * (x - px) + (y - py) * (y - py))) : 0.0;
+	return r;
+}
+
+int main() {
+	const int degrees[] = { 1, 2, 3, 4, 5, 6, 8, 12, 16, 24, 32, 48, 64 };
+	const int sampleCounts[] = { 100, 1000, 10000 };
+
+	struct Strategy {
+		const char* name;
+		Result(*run)(const vector<Point>&, int);
+		bool perSampleCount;
+	};
+	const Strategy strategies[] = {
+		{ "bernstein", benchBernstein, true },
+		{ "deCasteljau", benchDeCasteljau, true },
+		{ "fixed", benchFixed, true },
+		{ "genBezierCurvePoints", benchGenCurve, true },
+		{ "genAssistantLinePoints", benchAssistant, false },
+	};
+
+	std::mt19937 rng(2019);
+	std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+
+	printf("%-24s %6s %8s %12s %12s %12s\n", "strategy", "degree", "samples", "ns/sample", "allocs/call", "max error");
+	for (int degree : degrees) {
+		vector<Point> ps;
+		for (int i = 0; i <= degree; i++) ps.push_back(Point(coord(rng), coord(rng)));
+		for (const Strategy& s : strategies) {
+			for (int samples : sampleCounts) {
+				Result r = s.run(ps, samples);
+				printf("%-24s %6d %8s %12.2f %12.1f %12.3g\n", s.name, degree,
+					s.perSampleCount ? std::to_string(samples).c_str() : "-", r.nsPerSample, r.allocsPerCall, r.maxError);
+				if (!s.perSampleCount) break;
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#ifndef _ARC_LENGTH_H_
+#define _ARC_LENGTH_H_
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "Bezier.h"
+
+namespace Bezier {
+
+	using std::vector;
+
+	// ߿Ƶ㲻ʱֻbuildһ
+	// lengths[i]t0 i / intervals Ļinverseǰȷֵt
+	// tAtֲO(log n)tAtFastֱӲinverseO(1)
+	class ArcLengthTable {
+	public:
+		vector<float> lengths;
+		vector<float> inverse;
+
+		// intervalsΪֶÿ5Gauss-Legendreٶ|B'(t)|
+		void build(const vector<Point>& ps, int intervals = 256, int inverseSize = 1024) {
+			lengths.assign(1, 0.0f);
+			inverse.clear();
+			if (ps.size() < 2 || intervals < 1) return;
+
+			static const double nodes[5] = { 0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640 };
+			static const double weights[5] = { 0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891 };
+
+			DeCasteljau evaluator;
+			double total = 0;
+			for (int i = 0; i < intervals; i++) {
+				double a = (double)i / intervals, b = (double)(i + 1) / intervals;
+				double half = (b - a) / 2, mid = (a + b) / 2, sum = 0;
+				for (int k = 0; k < 5; k++) {
+					Point d;
+					evaluator.eval(ps, (float)(mid + half * nodes[k]), &d);
+					sum += weights[k] * std::sqrt((double)d.x * d.x + (double)d.y * d.y);
+				}
+				total += sum * half;
+				lengths.push_back((float)total);
+			}
+
+			// ȷֵӦtlengthsinverseҲ
+			inverse.resize((std::max)(inverseSize, 2));
+			for (size_t k = 0; k < inverse.size(); k++) {
+				inverse[k] = tAt(length() * k / (inverse.size() - 1));
+			}
+		}
+
+		float length() const {
+			return lengths.back();
+		}
+
+		// sӦĲtֺڶԲֵ
+		float tAt(float s) const {
+			int n = (int)lengths.size() - 1;
+			if (n < 1 || s <= 0) return 0.0f;
+			if (s >= length()) return 1.0f;
+			int i = int(std::upper_bound(lengths.begin(), lengths.end(), s) - lengths.begin()) - 1;
+			i = (std::min)((std::max)(i, 0), n - 1);
+			float seg = lengths[i + 1] - lengths[i];
+			float u = seg > 0 ? (s - lengths[i]) / seg : 0.0f;
+			return (i + u) / n;
+		}
+
+		// O(1)汾ȡinverseSize
+		float tAtFast(float s) const {
+			if (inverse.size() < 2 || s <= 0) return 0.0f;
+			if (s >= length()) return 1.0f;
+			float x = s / length() * (inverse.size() - 1);
+			int k = (std::min)((int)x, (int)inverse.size() - 2);
+			float u = x - k;
+			return inverse[k] * (1 - u) + inverse[k + 1] * u;
+		}
+
+		// ߹ܻfraction01ʱĲt
+		// ƵȫغʱΪ0޴֣˻t = fractionǰ
+		float tAtFraction(float fraction) const {
+			if (length() <= 0) return (std::min)((std::max)(fraction, 0.0f), 1.0f);
+			return tAtFast(fraction * length());
+		}
+
+		// ػȾȡcountڰ
+		vector<float> equidistantParams(int count) const {
+			vector<float> ts;
+			for (int k = 0; k < count; k++) {
+				ts.push_back(tAtFraction(count > 1 ? (float)k / (count - 1) : 0.0f));
+			}
+			return ts;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,277 @@
+#pragma once
+#ifndef _BSPLINE_H_
+#define _BSPLINE_H_
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <glad/glad.h>
+#include "Bezier.h"
+
+namespace BSpline {
+
+	using std::vector;
+	using Bezier::Point;
+
+	enum KnotType {
+		UNIFORM,    // Ƚڵ 0, 1, 2, ...߲βƵ
+		CLAMPED,    // ظdegree+1εľȽڵ㣬߾βƵ
+		CUSTOM      // ǾȽڵ㣬setKnots
+	};
+
+	// B/NURBS
+	// ڵ(span)ţjspanռ [j * samplesPerSpan, (j + 1) * samplesPerSpan) 㣬
+	// ٶһյ㣬ֱGL_LINE_STRIP
+	// iƵֻӰ [i - degree, i] degree + 1span޸ʱֻ㡢ֻϴЩspan
+	class Curve {
+	public:
+		int degree;
+		KnotType type;
+		int samplesPerSpan;
+		vector<Point> points;
+		vector<float> weights;   // ȫΪ1ʱͨB
+		vector<float> knots;
+		vector<float> vertices;  // ÿ3float
+
+		// ҪϴĶ㷶Χ [dirtyFrom, dirtyTo)
+		int dirtyFrom = 0, dirtyTo = 0;
+
+		Curve(int degree_ = 3, KnotType type_ = CLAMPED, int samplesPerSpan_ = 32)
+			: degree(degree_), type(type_), samplesPerSpan(samplesPerSpan_) {}
+
+		int spans() const {
+			return (std::max)(0, (int)points.size() - degree);
+		}
+
+		int vertexCount() const {
+			return spans() > 0 ? spans() * samplesPerSpan + 1 : 0;
+		}
+
+		// ÿƵ㣬ȫ
+		void setPoints(const vector<Point>& ps, const vector<float>& ws = vector<float>()) {
+			points = ps;
+			weights = ws.size() == ps.size() ? ws : vector<float>(ps.size(), 1.0f);
+			if (type != CUSTOM || knots.size() != points.size() + degree + 1) genKnots();
+			rebuildAll();
+		}
+
+		// ǾȽڵ㣬Ϊ Ƶ + degree + 1
+		void setKnots(const vector<float>& ks) {
+			vector<float> oldKnots = knots;
+			vector<float> oldVertices = vertices;
+			type = CUSTOM;
+			knots = ks;
+			vector<int> sameMap(spans());
+			for (int j = 0; j < spans(); j++) sameMap[j] = j;
+			rebuild(oldKnots, oldVertices, sameMap);
+		}
+
+		// ƶһƵ㣨NURBSͬʱ޸ȨأֻӰspan
+		void moveControlPoint(int i, Point p, float w = -1.0f) {
+			points[i] = p;
+			if (w > 0) weights[i] = w;
+			if (spans() == 0) return;
+			int from = (std::max)(0, i - degree), to = (std::min)(spans() - 1, i);
+			for (int j = from; j <= to; j++) evalSpan(j);
+			if (to == spans() - 1) evalEnd();
+			markDirty(from * samplesPerSpan, to == spans() - 1 ? vertexCount() : (to + 1) * samplesPerSpan);
+		}
+
+		// λiƵ
+		void insertControlPoint(int i, Point p, float w = 1.0f) {
+			vector<float> oldKnots = knots;
+			vector<float> oldVertices = vertices;
+			int oldSpans = spans();
+			points.insert(points.begin() + i, p);
+			weights.insert(weights.begin() + i, w);
+			if (type == CUSTOM && oldKnots.size() > (size_t)2 * degree + 2) {
+				int k = interiorKnotIndex(i);
+				knots.insert(knots.begin() + k, (knots[k - 1] + knots[k]) / 2);
+			} else {
+				genKnots();
+			}
+			rebuild(oldKnots, oldVertices, spanMap(i, 1, oldSpans));
+		}
+
+		// ɾiƵ
+		void eraseControlPoint(int i) {
+			vector<float> oldKnots = knots;
+			vector<float> oldVertices = vertices;
+			int oldSpans = spans();
+			points.erase(points.begin() + i);
+			weights.erase(weights.begin() + i);
+			if (type == CUSTOM && oldKnots.size() > (size_t)2 * degree + 3) {
+				knots.erase(knots.begin() + interiorKnotIndex(i));
+			} else {
+				genKnots();
+			}
+			rebuild(oldKnots, oldVertices, spanMap(i, -1, oldSpans));
+		}
+
+		// uĵ㣬u [knots[degree], knots[Ƶ]] ֮
+		Point eval(float u) {
+			int span = findSpan(u);
+			return deBoor(span, u);
+		}
+
+		// ϴVBOʱֻglBufferSubData
+		void upload(GLuint VBO) {
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			size_t bytes = sizeof(float) * vertices.size();
+			if (bytes > capacity) {
+				capacity = (std::max)(bytes, capacity * 2);
+				glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_DYNAMIC_DRAW);
+				glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, vertices.data());
+			} else if (dirtyFrom < dirtyTo) {
+				glBufferSubData(GL_ARRAY_BUFFER, sizeof(float) * 3 * dirtyFrom,
+					sizeof(float) * 3 * (dirtyTo - dirtyFrom), &vertices[(size_t)dirtyFrom * 3]);
+			}
+			dirtyFrom = dirtyTo = 0;
+		}
+
+	private:
+		size_t capacity = 0;
+		vector<float> hx, hy, hw;   // de Boorscratch
+
+		void genKnots() {
+			int m = (int)points.size() + degree + 1;
+			knots.resize(m);
+			if (type == UNIFORM) {
+				for (int k = 0; k < m; k++) knots[k] = (float)k;
+			} else {
+				int last = (int)points.size() - degree;
+				for (int k = 0; k < m; k++)
+					knots[k] = (float)(std::min)((std::max)(k - degree, 0), (std::max)(last, 0));
+			}
+		}
+
+		// ǾȽڵ/ɾλã˵ظڵ㲻
+		int interiorKnotIndex(int i) {
+			int lo = degree + 1, hi = (int)knots.size() - degree - 1;
+			return (std::min)((std::max)(i + (degree + 1) / 2, lo), (std::max)(lo, hi - 1));
+		}
+
+		// span jӦľspanţ-1ʾƵ㴰ڱ˱
+		// deltaΪ1ʾi룬-1ʾɾ˵i
+		vector<int> spanMap(int i, int delta, int oldSpans) {
+			vector<int> map(spans(), -1);
+			for (int j = 0; j < spans(); j++) {
+				int old = -1;
+				if (j + degree < i) old = j;
+				else if (delta > 0 && j > i) old = j - 1;
+				else if (delta < 0 && j >= i) old = j + 1;
+				map[j] = old < oldSpans ? old : -1;
+			}
+			return map;
+		}
+
+		// mapþɵĲspan¼
+		// span j״ֻͿƵ j..j+degree Լڵ knots[j+1..j+2*degree] йأ
+		// ߶ûֱӿɵĲֵ
+		void rebuild(const vector<float>& oldKnots, const vector<float>& oldVertices, const vector<int>& map) {
+			int n = spans();
+			int S = samplesPerSpan;
+			vertices.resize((size_t)vertexCount() * 3);
+			int firstChanged = -1;
+			for (int j = 0; j < n; j++) {
+				int old = map[j];
+				bool reuse = old >= 0 && (size_t)(old + 1) * S * 3 <= oldVertices.size()
+					&& sameKnotGaps(oldKnots, old, j);
+				if (reuse) {
+					if (old != j && firstChanged < 0) firstChanged = j;
+					memmove(&vertices[(size_t)j * S * 3], &oldVertices[(size_t)old * S * 3], sizeof(float) * S * 3);
+				} else {
+					if (firstChanged < 0) firstChanged = j;
+					evalSpan(j);
+				}
+			}
+			if (n > 0) {
+				evalEnd();
+				if (firstChanged < 0) firstChanged = n - 1;
+				markDirty(firstChanged * S, vertexCount());
+			}
+		}
+
+		void rebuildAll() {
+			vertices.resize((size_t)vertexCount() * 3);
+			for (int j = 0; j < spans(); j++) evalSpan(j);
+			if (spans() > 0) evalEnd();
+			markDirty(0, vertexCount());
+		}
+
+		bool sameKnotGaps(const vector<float>& oldKnots, int oldSpan, int span) {
+			for (int k = 1; k < 2 * degree; k++) {
+				int a = span + k, b = oldSpan + k;
+				if (a + 1 >= (int)knots.size() || b + 1 >= (int)oldKnots.size()) return false;
+				if (knots[a + 1] - knots[a] != oldKnots[b + 1] - oldKnots[b]) return false;
+			}
+			return true;
+		}
+
+		void markDirty(int from, int to) {
+			if (dirtyFrom >= dirtyTo) {
+				dirtyFrom = from;
+				dirtyTo = to;
+			} else {
+				dirtyFrom = (std::min)(dirtyFrom, from);
+				dirtyTo = (std::max)(dirtyTo, to);
+			}
+			dirtyTo = (std::min)(dirtyTo, vertexCount());
+		}
+
+		void evalSpan(int j) {
+			float u0 = knots[j + degree], u1 = knots[j + degree + 1];
+			float* out = &vertices[(size_t)j * samplesPerSpan * 3];
+			for (int s = 0; s < samplesPerSpan; s++) {
+				Point p = deBoor(j, u0 + (u1 - u0) * s / samplesPerSpan);
+				out[s * 3] = p.x;
+				out[s * 3 + 1] = p.y;
+				out[s * 3 + 2] = 0.0f;
+			}
+		}
+
+		void evalEnd() {
+			int last = spans() - 1;
+			Point p = deBoor(last, knots[last + degree + 1]);
+			float* out = &vertices[(size_t)spans() * samplesPerSpan * 3];
+			out[0] = p.x;
+			out[1] = p.y;
+			out[2] = 0.0f;
+		}
+
+		int findSpan(float u) {
+			int n = spans();
+			if (n == 0) return -1;
+			// ҵ knots[j + degree] <= u < knots[j + degree + 1]
+			auto begin = knots.begin() + degree, end = knots.begin() + degree + n;
+			int j = int(std::upper_bound(begin, end + 1, u) - begin) - 1;
+			return (std::min)((std::max)(j, 0), n - 1);
+		}
+
+		// ڵjspande Boor¼㣬NURBSB
+		Point deBoor(int j, float u) {
+			int p = degree;
+			hx.resize(p + 1);
+			hy.resize(p + 1);
+			hw.resize(p + 1);
+			for (int k = 0; k <= p; k++) {
+				float w = weights[j + k];
+				hx[k] = points[j + k].x * w;
+				hy[k] = points[j + k].y * w;
+				hw[k] = w;
+			}
+			for (int r = 1; r <= p; r++) {
+				for (int k = p; k >= r; k--) {
+					float a = knots[j + k], b = knots[j + k + p + 1 - r];
+					float alpha = b > a ? (u - a) / (b - a) : 0.0f;
+					hx[k] = (1 - alpha) * hx[k - 1] + alpha * hx[k];
+					hy[k] = (1 - alpha) * hy[k - 1] + alpha * hy[k];
+					hw[k] = (1 - alpha) * hw[k - 1] + alpha * hw[k];
+				}
+			}
+			return Point(hx[p] / hw[p], hy[p] / hw[p]);
+		}
+	};
+}
+
+#endif
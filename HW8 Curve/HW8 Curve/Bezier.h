@@ -6,6 +6,8 @@
 #include <glad/glad.h>
 #include <functional>
 #include <vector>
+#include <cmath>
+#include <algorithm>
 #include "mUtils.h"
 #include <windows.h>
 
@@ -23,7 +25,7 @@ namespace Bezier {
 	struct Point {
 		float x;
 		float y;
-		Point(float x_, float y_) : x(x_), y(y_) {}
+		Point(float x_ = 0.0f, float y_ = 0.0f) : x(x_), y(y_) {}
 
 		Point operator +(const Point& other) {
 			return Point(this->x + other.x, this->y + other.y);
@@ -49,11 +51,75 @@ namespace Bezier {
 		return rv;
 	}
 
+	// double۳ˣϸʱint׳
 	float bernstein(int i, int n, float t) {
-		int tmp1 = 1, tmp2 = 1, tmp3 = 1;
-		for (int j = i + 1; j <= n; j++) tmp1 *= j;
-		for (int j = 1; j <= n - i; j++) tmp2 *= j;
-		return ((float)tmp1 / (float)tmp2) * pow(t, i) * pow(1 - t, n - i);
+		double c = 1.0;
+		for (int j = 1; j <= i; j++) c = c * (n - i + j) / j;
+		return (float)(c * pow(t, i) * pow(1 - t, n - i));
+	}
+
+	// de CasteljauֵscratchֻһΣڶβ֮临
+	// ÿֵO(n^2)βֵֻ͹ϣ߽ʱֵȶ
+	class DeCasteljau {
+	public:
+		// B(t)dǿʱͬʱB'(t)
+		Point eval(const vector<Point>& ps, float t, Point* d = nullptr) {
+			int n = (int)ps.size() - 1;
+			if (n < 0) return Point();
+			if (n == 0) {
+				if (d) *d = Point();
+				return ps[0];
+			}
+			xs.resize(n + 1);
+			ys.resize(n + 1);
+			for (int i = 0; i <= n; i++) {
+				xs[i] = ps[i].x;
+				ys[i] = ps[i].y;
+			}
+			float s = 1 - t;
+			// ֻʣΪֹĲǵ
+			for (int k = n; k > 1; k--) {
+				for (int i = 0; i < k; i++) {
+					xs[i] = s * xs[i] + t * xs[i + 1];
+					ys[i] = s * ys[i] + t * ys[i + 1];
+				}
+			}
+			if (d) *d = Point(n * (xs[1] - xs[0]), n * (ys[1] - ys[0]));
+			return Point(s * xs[0] + t * xs[1], s * ys[0] + t * ys[1]);
+		}
+
+	private:
+		vector<float> xs, ys;
+	};
+
+	// Ƶеde CasteljauһΪȡÿһĵһ㣬Ұȡһ
+	void splitHalf(const vector<Point>& ps, vector<Point>& left, vector<Point>& right) {
+		int n = (int)ps.size() - 1;
+		left.resize(n + 1);
+		right.resize(n + 1);
+		vector<Point> tmp = ps;
+		for (int k = 0; k <= n; k++) {
+			left[k] = tmp[0];
+			right[n - k] = tmp[n - k];
+			for (int i = 0; i < n - k; i++) {
+				tmp[i] = Point((tmp[i].x + tmp[i + 1].x) / 2, (tmp[i].y + tmp[i + 1].y) / 2);
+			}
+		}
+	}
+
+	// Ƶβߵ룬СݲʱһοԵ߶
+	float flatnessOf(const vector<Point>& ps) {
+		Point a = ps.front(), b = ps.back();
+		float dx = b.x - a.x, dy = b.y - a.y;
+		float len = std::sqrt(dx * dx + dy * dy);
+		float d = 0;
+		for (auto& p : ps) {
+			float e = len > 1e-12f
+				? std::abs((p.x - a.x) * dy - (p.y - a.y) * dx) / len
+				: std::sqrt((p.x - a.x) * (p.x - a.x) + (p.y - a.y) * (p.y - a.y));
+			d = (std::max)(d, e);
+		}
+		return d;
 	}
 
 	// 1Bizierߣֱ
@@ -83,19 +149,97 @@ namespace Bezier {
 	}
 
 	// ׵Bezier
-	vector<float> genBezierCurvePoints(vector<Point> ps, float tLimit=1.0f) {
-		int n = ps.size() - 1; // n + 1 
-		//if (n>2) n = 2;
+	vector<float> genBezierCurvePoints(const vector<Point>& ps, float tLimit=1.0f) {
 		vector<Point> points;
+		if (ps.empty()) return pointsToFloat3(points);
+		DeCasteljau evaluator;
 
 		for (float t = 0; t < tLimit; t += deltaT) {
-			Point next(0, 0);
-			for (int i = 0; i < n + 1; i++) { // 0  n ʾ n + 1 
-				float param = bernstein(i, n, t);
-				next.x += ps[i].x * param;
-				next.y += ps[i].y * param;
+			points.push_back(evaluator.eval(ps, t));
+		}
+
+		return pointsToFloat3(points);
+	}
+
+	// һBezierӦԭ߲[t0, t1]
+	struct CubicSegment {
+		float t0, t1;
+		Point p[4];
+
+		Point eval(float u) const {
+			float s = 1 - u;
+			float b0 = s * s * s, b1 = 3 * s * s * u, b2 = 3 * s * u * u, b3 = u * u * u;
+			return Point(b0 * p[0].x + b1 * p[1].x + b2 * p[2].x + b3 * p[3].x,
+				b0 * p[0].y + b1 * p[1].y + b2 * p[2].y + b3 * p[3].y);
+		}
+	};
+
+	// Ѹ߽תɷֶ
+	// ÿö˵Ͷ˵㵼HermiteߣtoleranceͶ֣
+	// Ը֮λú߶״ԭߵĲtolerance
+	vector<CubicSegment> toPiecewiseCubic(const vector<Point>& ps, float tolerance = 0.001f, int maxDepth = 12) {
+		vector<CubicSegment> segments;
+		if (ps.size() < 2) return segments;
+		DeCasteljau evaluator;
+
+		std::function<void(float, Point, Point, float, Point, Point, int)> fit =
+			[&](float t0, Point b0, Point d0, float t1, Point b1, Point d1, int depth) {
+			float h = (t1 - t0) / 3;
+			CubicSegment seg;
+			seg.t0 = t0;
+			seg.t1 = t1;
+			seg.p[0] = b0;
+			seg.p[1] = Point(b0.x + d0.x * h, b0.y + d0.y * h);
+			seg.p[2] = Point(b1.x - d1.x * h, b1.y - d1.y * h);
+			seg.p[3] = b1;
+
+			float err = 0;
+			for (int k = 1; k < 4; k++) {
+				float u = k / 4.0f;
+				Point a = evaluator.eval(ps, t0 + (t1 - t0) * u);
+				Point c = seg.eval(u);
+				err = (std::max)(err, (std::max)(std::abs(a.x - c.x), std::abs(a.y - c.y)));
+			}
+			if (err <= tolerance || depth >= maxDepth) {
+				segments.push_back(seg);
+				return;
 			}
-			points.push_back(next);
+			float tm = (t0 + t1) / 2;
+			Point dm;
+			Point bm = evaluator.eval(ps, tm, &dm);
+			fit(t0, b0, d0, tm, bm, dm, depth + 1);
+			fit(tm, bm, dm, t1, b1, d1, depth + 1);
+		};
+
+		Point d0, d1;
+		Point b0 = evaluator.eval(ps, 0.0f, &d0);
+		Point b1 = evaluator.eval(ps, 1.0f, &d1);
+		fit(0.0f, b0, d0, 1.0f, b1, d1, 0);
+		return segments;
+	}
+
+	// ֶԭ߲tĵ㣬ҵtڵĶ
+	Point evalPiecewise(const vector<CubicSegment>& segments, float t) {
+		size_t lo = 0, hi = segments.size() - 1;
+		while (lo < hi) {
+			size_t mid = (lo + hi) / 2;
+			if (t > segments[mid].t1) lo = mid + 1;
+			else hi = mid;
+		}
+		const CubicSegment& seg = segments[lo];
+		return seg.eval((t - seg.t0) / (seg.t1 - seg.t0));
+	}
+
+	// Էֶ߲tȡgenBezierCurvePointsһ
+	vector<float> genBezierCurvePoints(const vector<CubicSegment>& segments, float tLimit = 1.0f) {
+		vector<Point> points;
+		if (segments.empty()) return pointsToFloat3(points);
+		size_t k = 0;
+
+		for (float t = 0; t < tLimit; t += deltaT) {
+			while (k + 1 < segments.size() && t > segments[k].t1) k++;
+			const CubicSegment& seg = segments[k];
+			points.push_back(seg.eval((t - seg.t0) / (seg.t1 - seg.t0)));
 		}
 
 		return pointsToFloat3(points);
@@ -107,35 +251,31 @@ namespace Bezier {
 		return Point(x, y);
 	}
 
-	vector<float> genAssistantLinePoints(vector<Point> ps, float tLimit = 1.0f) {
-		int n = ps.size() - 1;
-		vector<Point> points, tPoints;
-		vector<float> pointsF;
+	// de Casteljauߣֱ߶ζ˵㣨ÿһ߶ΣGL_LINES
+	// ׷ӵout棬ֵͬһscratchԭ
+	void genAssistantLinePoints(const vector<Point>& ps, float tLimit, vector<float>& out) {
+		int n = (int)ps.size() - 1;
+		if (n < 1) return;
+		// ƶn + ÿһ n(n+1)/2 ߶
+		out.reserve(out.size() + (size_t)n * (n + 1) * 3);
+		auto segment = [&out](const Point& p1, const Point& p2) {
+			out.push_back(p1.x); out.push_back(p1.y); out.push_back(0.0f);
+			out.push_back(p2.x); out.push_back(p2.y); out.push_back(0.0f);
+		};
+
 		// ֱ
-		for (int i = 0; i < n; i++) {
-			vector<float> tmp = genBezierCurvePoints(ps[i], ps[i + 1]);
-			pointsF.insert(pointsF.end(), tmp.begin(), tmp.end());
-		}
-		
-		tPoints.assign(ps.begin(), ps.end());
-		
-		for (int j = 0; j < n; j++) {
-			points.clear();
-
-			points.push_back(genPointPercentage(tPoints[0], tPoints[1], tLimit));
-
-			for (int i = 0; i < tPoints.size() - 2; i++) {
-				Point p1 = genPointPercentage(tPoints[i], tPoints[i + 1], tLimit);
-				Point p2 = genPointPercentage(tPoints[i + 1], tPoints[i + 2], tLimit);
-				vector<float> tmp = genBezierCurvePoints(p1, p2);
-				pointsF.insert(pointsF.end(), tmp.begin(), tmp.end());
-				
-				points.push_back(p2);
-			}
-			tPoints.clear();
-			tPoints.assign(points.begin(), points.end());
+		for (int i = 0; i < n; i++) segment(ps[i], ps[i + 1]);
+
+		vector<Point> scratch(ps.begin(), ps.end());
+		for (int k = n; k > 1; k--) {
+			for (int i = 0; i < k; i++) scratch[i] = genPointPercentage(scratch[i], scratch[i + 1], tLimit);
+			for (int i = 0; i < k - 1; i++) segment(scratch[i], scratch[i + 1]);
 		}
+	}
 
+	vector<float> genAssistantLinePoints(const vector<Point>& ps, float tLimit = 1.0f) {
+		vector<float> pointsF;
+		genAssistantLinePoints(ps, tLimit, pointsF);
 		return pointsF;
 	}
 
@@ -0,0 +1,236 @@
+#pragma once
+#ifndef _BOUNDS_H_
+#define _BOUNDS_H_
+
+#include <vector>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include "Bezier.h"
+
+namespace Bezier {
+
+	using std::vector;
+
+	struct AABB {
+		float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+
+		AABB() {}
+		AABB(float minX_, float minY_, float maxX_, float maxY_)
+			: minX(minX_), minY(minY_), maxX(maxX_), maxY(maxY_) {}
+
+		bool empty() const {
+			return minX > maxX || minY > maxY;
+		}
+
+		void extend(Point p) {
+			minX = (std::min)(minX, p.x);
+			minY = (std::min)(minY, p.y);
+			maxX = (std::max)(maxX, p.x);
+			maxY = (std::max)(maxY, p.y);
+		}
+
+		bool intersects(const AABB& o) const {
+			return !empty() && !o.empty() && minX <= o.maxX && o.minX <= maxX && minY <= o.maxY && o.minY <= maxY;
+		}
+	};
+
+	// һάBernsteinʽ [0, 1] ڵĸcΪϵ
+	// ϵȫͬʱɱһ޸ֻһαʱǡһ
+	// ţٵʱ˻ض֣еϸֺݹ
+	void bernsteinRoots(const vector<double>& c, double t0, double t1, vector<double>& roots, int depth = 0) {
+		int n = (int)c.size() - 1;
+		if (n < 1) return;
+		int changes = 0;
+		for (int i = 0; i < n; i++) {
+			if ((c[i] < 0) != (c[i + 1] < 0)) changes++;
+		}
+		if (changes == 0) return;
+
+		if ((changes == 1 && (c[0] < 0) != (c[n] < 0)) || depth >= 40) {
+			auto eval = [&](double u, double& d) {
+				vector<double> b = c;
+				for (int k = n; k > 1; k--)
+					for (int i = 0; i < k; i++) b[i] = (1 - u) * b[i] + u * b[i + 1];
+				d = n * (b[1] - b[0]);
+				return (1 - u) * b[0] + u * b[1];
+			};
+			double lo = 0, hi = 1, u = 0.5, d;
+			bool loNeg = c[0] < 0;
+			for (int it = 0; it < 50; it++) {
+				double f = eval(u, d);
+				if ((f < 0) == loNeg) lo = u;
+				else hi = u;
+				double next = d != 0 ? u - f / d : (lo + hi) / 2;
+				if (next <= lo || next >= hi) next = (lo + hi) / 2;
+				if (std::abs(next - u) < 1e-12) break;
+				u = next;
+			}
+			roots.push_back(t0 + (t1 - t0) * u);
+			return;
+		}
+
+		// de CasteljauеϵһΪ
+		vector<double> left(n + 1), right(n + 1), tmp = c;
+		for (int k = 0; k <= n; k++) {
+			left[k] = tmp[0];
+			right[n - k] = tmp[n - k];
+			for (int i = 0; i < n - k; i++) tmp[i] = (tmp[i] + tmp[i + 1]) / 2;
+		}
+		double m = (t0 + t1) / 2;
+		bernsteinRoots(left, t0, m, roots, depth + 1);
+		bernsteinRoots(right, m, t1, roots, depth + 1);
+	}
+
+	// һ B'(t) = 0  (0, 1) ڵĸ
+	// 3µǶʽֱӽ̣߽ⷽϸ
+	void derivativeRoots(const vector<float>& p, vector<double>& roots) {
+		int n = (int)p.size() - 1;
+		if (n == 2) {
+			double den = (double)p[0] - 2.0 * p[1] + p[2];
+			if (den != 0) roots.push_back(((double)p[0] - p[1]) / den);
+		} else if (n == 3) {
+			// B'(t) / 3 = a t^2 + b t + c
+			double a = -(double)p[0] + 3.0 * p[1] - 3.0 * p[2] + p[3];
+			double b = 2.0 * ((double)p[0] - 2.0 * p[1] + p[2]);
+			double c = (double)p[1] - p[0];
+			if (std::abs(a) < 1e-12) {
+				if (b != 0) roots.push_back(-c / b);
+			} else {
+				double disc = b * b - 4 * a * c;
+				if (disc >= 0) {
+					// ʧ
+					double q = -(b + (b < 0 ? -1 : 1) * std::sqrt(disc)) / 2;
+					roots.push_back(q / a);
+					if (q != 0) roots.push_back(c / q);
+				}
+			}
+		} else if (n > 3) {
+			vector<double> d(n);
+			for (int i = 0; i < n; i++) d[i] = (double)p[i + 1] - p[i];
+			bernsteinRoots(d, 0.0, 1.0, roots);
+		}
+	}
+
+	// ߱ľȷΧУ˵xyΪ0ĵ
+	// ȿƵİΧнƵߺԶʱ
+	AABB tightBounds(const vector<Point>& ps) {
+		AABB box;
+		if (ps.empty()) return box;
+		box.extend(ps.front());
+		box.extend(ps.back());
+
+		vector<float> xs, ys;
+		for (auto& p : ps) {
+			xs.push_back(p.x);
+			ys.push_back(p.y);
+		}
+		vector<double> roots;
+		derivativeRoots(xs, roots);
+		derivativeRoots(ys, roots);
+
+		DeCasteljau evaluator;
+		for (double t : roots) {
+			if (t > 0 && t < 1) box.extend(evaluator.eval(ps, (float)t));
+		}
+		return box;
+	}
+
+	// ƶε͹Andrewʱ룬ߵ
+	vector<Point> convexHull(vector<Point> ps) {
+		std::sort(ps.begin(), ps.end(), [](const Point& a, const Point& b) {
+			return a.x < b.x || (a.x == b.x && a.y < b.y);
+		});
+		if (ps.size() < 3) return ps;
+		auto cross = [](const Point& o, const Point& a, const Point& b) {
+			return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+		};
+		vector<Point> hull(2 * ps.size());
+		int k = 0;
+		for (size_t i = 0; i < ps.size(); i++) {
+			while (k >= 2 && cross(hull[k - 2], hull[k - 1], ps[i]) <= 0) k--;
+			hull[k++] = ps[i];
+		}
+		for (int i = (int)ps.size() - 2, lower = k + 1; i >= 0; i--) {
+			while (k >= lower && cross(hull[k - 2], hull[k - 1], ps[i]) <= 0) k--;
+			hull[k++] = ps[i];
+		}
+		hull.resize(k - 1);
+		return hull;
+	}
+
+	// ͹;Ƿཻ᣺ε͹ÿߣ
+	bool hullIntersects(const vector<Point>& hull, const AABB& box) {
+		if (hull.empty() || box.empty()) return false;
+		AABB hb;
+		for (auto& p : hull) hb.extend(p);
+		if (!hb.intersects(box)) return false;
+		Point corners[4] = { Point(box.minX, box.minY), Point(box.maxX, box.minY), Point(box.maxX, box.maxY), Point(box.minX, box.maxY) };
+		for (size_t i = 0; i < hull.size() && hull.size() >= 2; i++) {
+			const Point& a = hull[i];
+			const Point& b = hull[(i + 1) % hull.size()];
+			// ʱ͹ĸǶĳߵҲͷˣ
+			// ֻʱһΣ߶
+			bool allOutside = true;
+			for (auto& c : corners) {
+				if ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x) >= 0) {
+					allOutside = false;
+					break;
+				}
+			}
+			if (allOutside) return false;
+		}
+		return true;
+	}
+
+	// Χк͹BezierߣƵĶһηʱ¼
+	class Curve {
+	public:
+		Curve() {}
+		Curve(const vector<Point>& ps) : points(ps) {}
+
+		const vector<Point>& controlPoints() const {
+			return points;
+		}
+
+		void setPoints(const vector<Point>& ps) {
+			points = ps;
+			dirty = true;
+		}
+
+		void moveControlPoint(int i, Point p) {
+			points[i] = p;
+			dirty = true;
+		}
+
+		const AABB& bounds() {
+			update();
+			return box;
+		}
+
+		const vector<Point>& hull() {
+			update();
+			return hullPoints;
+		}
+
+		// ȱȰΧУ͹ųΧӿֻڽص
+		bool visible(const AABB& viewport) {
+			return bounds().intersects(viewport) && hullIntersects(hull(), viewport);
+		}
+
+	private:
+		vector<Point> points;
+		AABB box;
+		vector<Point> hullPoints;
+		bool dirty = true;
+
+		void update() {
+			if (!dirty) return;
+			box = tightBounds(points);
+			hullPoints = convexHull(points);
+			dirty = false;
+		}
+	};
+}
+
+#endif
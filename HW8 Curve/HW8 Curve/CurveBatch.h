@@ -0,0 +1,208 @@
+#pragma once
+#ifndef _CURVE_BATCH_H_
+#define _CURVE_BATCH_H_
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <glad/glad.h>
+#include "Bezier.h"
+#include "Bounds.h"
+
+namespace Bezier {
+
+	using std::vector;
+
+	// ͬһ߷һ飬Ƶ㰴SoA
+	// kߵĵiƵΪ xs[k * (degree + 1) + i], ys[...]
+	struct DegreeGroup {
+		int degree;
+		vector<float> xs;
+		vector<float> ys;
+		vector<int> curveIds;   // ڵkbatchеı
+		vector<float> basis;    // samples * (degree + 1) Bernsteinϵͬ鹲
+		int basisSamples = 0;
+
+		DegreeGroup(int degree_) : degree(degree_) {}
+	};
+
+	// һֵдͬһ㻺壬glMultiDrawArrays
+	// ӿʱΧл͹ӿ߲Ϊ0
+	class CurveBatch {
+	public:
+		vector<DegreeGroup> groups;
+		vector<float> vertices;      // ߵĲ㣬ÿ3float
+		vector<GLint> firsts;        // ÿverticesеʼ
+		vector<GLsizei> counts;      // ÿߵĶ
+		int samples;                 // ÿߵĲ
+
+		CurveBatch(int samples_ = (int)(1.0f / deltaT)) : samples(samples_) {}
+
+		// һߣ
+		int addCurve(const vector<Point>& ps) {
+			int degree = (int)ps.size() - 1;
+			int id = (int)curveGroup.size();
+			bounds.push_back(tightBounds(ps));
+			hulls.push_back(convexHull(ps));
+			if (degree < 1) {
+				curveGroup.push_back(-1);
+				curveLocal.push_back(0);
+				return id;
+			}
+
+			DegreeGroup& g = groupOf(degree);
+			curveGroup.push_back(int(&g - groups.data()));
+			curveLocal.push_back((int)g.curveIds.size());
+			g.curveIds.push_back(id);
+			for (auto& p : ps) {
+				g.xs.push_back(p.x);
+				g.ys.push_back(p.y);
+			}
+			return id;
+		}
+
+		int size() const {
+			return (int)curveGroup.size();
+		}
+
+		void clear() {
+			groups.clear();
+			curveGroup.clear();
+			curveLocal.clear();
+			bounds.clear();
+			hulls.clear();
+			vertices.clear();
+			firsts.clear();
+			counts.clear();
+		}
+
+		// ߱İΧУƵʱ
+		const AABB& boundsOf(int c) const {
+			return bounds[c];
+		}
+
+		const vector<Point>& hullOf(int c) const {
+			return hulls[c];
+		}
+
+		bool visible(int c, const AABB& viewport) const {
+			return bounds[c].intersects(viewport) && hullIntersects(hulls[c], viewport);
+		}
+
+		// ȫߣthreadsΪ0ʱʹȫ
+		void evaluate(unsigned threads = 0) {
+			evaluateCulled(nullptr, threads);
+		}
+
+		// ֻviewportཻ
+		void evaluate(const AABB& viewport, unsigned threads = 0) {
+			evaluateCulled(&viewport, threads);
+		}
+
+		// ϴVBOVAOVBOΪ0ʱ½֮ÿevaluatebindͬһԶ
+		void bind(GLuint& VAO, GLuint& VBO) {
+			if (!VAO) glGenVertexArrays(1, &VAO);
+			if (!VBO) glGenBuffers(1, &VBO);
+			glBindVertexArray(VAO);
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertices.size(), vertices.data(), GL_DYNAMIC_DRAW);
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+			glEnableVertexAttribArray(0);
+		}
+
+		// һεû
+		void draw(GLuint VAO, GLenum mode = GL_LINE_STRIP) {
+			if (firsts.empty()) return;
+			glBindVertexArray(VAO);
+			glMultiDrawArrays(mode, firsts.data(), counts.data(), (GLsizei)firsts.size());
+		}
+
+	private:
+		vector<int> curveGroup;   // 飬-1ʾƵ㲻
+		vector<int> curveLocal;   // ڵ
+		vector<AABB> bounds;
+		vector<vector<Point>> hulls;
+
+		void evaluateCulled(const AABB* viewport, unsigned threads) {
+			int n = size();
+			firsts.assign(n, 0);
+			counts.assign(n, 0);
+			int total = 0;
+			for (int c = 0; c < n; c++) {
+				firsts[c] = total;
+				bool culled = curveGroup[c] < 0 || (viewport && !visible(c, *viewport));
+				counts[c] = culled ? 0 : samples;
+				total += counts[c];
+			}
+			vertices.resize((size_t)total * 3);
+
+			for (auto& g : groups) buildBasis(g);
+
+			if (threads == 0) threads = (std::max)(1u, std::thread::hardware_concurrency());
+			// ̫Сʱ̷߳
+			if ((size_t)total < 65536) threads = 1;
+			threads = (std::min<unsigned>)(threads, (std::max)(1, n));
+
+			if (threads == 1) {
+				evaluateRange(0, n);
+				return;
+			}
+			vector<std::thread> workers;
+			int chunk = (n + threads - 1) / threads;
+			for (unsigned i = 0; i < threads; i++) {
+				int from = i * chunk, to = (std::min)(n, from + chunk);
+				if (from >= to) break;
+				workers.emplace_back(&CurveBatch::evaluateRange, this, from, to);
+			}
+			for (auto& w : workers) w.join();
+		}
+
+		DegreeGroup& groupOf(int degree) {
+			for (auto& g : groups)
+				if (g.degree == degree) return g;
+			groups.push_back(DegreeGroup(degree));
+			return groups.back();
+		}
+
+		// ԤÿtӦϵ߲ͬظbernstein
+		void buildBasis(DegreeGroup& g) {
+			if (g.basisSamples == samples) return;
+			int m = g.degree + 1;
+			g.basis.resize((size_t)samples * m);
+			vector<double> binom(m, 1.0);
+			for (int i = 1; i < m; i++) binom[i] = binom[i - 1] * (g.degree - i + 1) / i;
+			for (int s = 0; s < samples; s++) {
+				double t = samples > 1 ? (double)s / (samples - 1) : 0.0;
+				for (int i = 0; i < m; i++) {
+					g.basis[(size_t)s * m + i] = (float)(binom[i] * pow(t, i) * pow(1 - t, g.degree - i));
+				}
+			}
+			g.basisSamples = samples;
+		}
+
+		void evaluateRange(int from, int to) {
+			for (int c = from; c < to; c++) {
+				if (counts[c] == 0) continue;
+				const DegreeGroup& g = groups[curveGroup[c]];
+				int m = g.degree + 1;
+				const float* xs = &g.xs[(size_t)curveLocal[c] * m];
+				const float* ys = &g.ys[(size_t)curveLocal[c] * m];
+				float* out = &vertices[(size_t)firsts[c] * 3];
+				for (int s = 0; s < samples; s++) {
+					const float* b = &g.basis[(size_t)s * m];
+					float x = 0, y = 0;
+					for (int i = 0; i < m; i++) {
+						x += b[i] * xs[i];
+						y += b[i] * ys[i];
+					}
+					out[s * 3] = x;
+					out[s * 3 + 1] = y;
+					out[s * 3 + 2] = 0.0f;
+				}
+			}
+		}
+	};
+}
+
+#endif
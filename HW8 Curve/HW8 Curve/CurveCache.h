@@ -0,0 +1,92 @@
+#pragma once
+#ifndef _CURVE_CACHE_H_
+#define _CURVE_CACHE_H_
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <glad/glad.h>
+#include "Bezier.h"
+#include "Kernels.h"
+
+namespace Bezier {
+
+	using std::vector;
+
+	// ߲棺k̶ t = k * deltaT
+	// tLimitʱֻ [tLimit, tLimit) ֣tLimitʱֱӻǰ׺
+	// Ƶ˲Ҫinvalidate
+	class CurveSampleCache {
+	public:
+		vector<float> vertices;   // õǰ׺ÿ3float
+
+		void invalidate() {
+			vertices.clear();
+			uploaded = 0;
+		}
+
+		int size() const {
+			return (int)(vertices.size() / 3);
+		}
+
+		// t < tLimit Ĳ
+		static int countFor(float tLimit) {
+			int total = (int)std::ceil(1.0f / deltaT);
+			return (std::min)((std::max)((int)std::ceil(tLimit / deltaT), 0), total);
+		}
+
+		// 뵽tLimitҪƵĶ
+		int extend(const vector<Point>& ps, float tLimit) {
+			int count = countFor(tLimit);
+			if (ps.empty()) return 0;
+			int from = size();
+			if (from >= count) return count;
+			// 5߱չİ汾
+			vertices.resize((size_t)count * 3);
+			sampleRange(ps, from, count, deltaT, &vertices[(size_t)from * 3]);
+			return count;
+		}
+
+		// ֶ߰汾
+		int extend(const vector<CubicSegment>& segments, float tLimit) {
+			int count = countFor(tLimit);
+			if (segments.empty()) return 0;
+			size_t s = 0;
+			for (int k = size(); k < count; k++) {
+				float t = k * deltaT;
+				while (s + 1 < segments.size() && t > segments[s].t1) s++;
+				const CubicSegment& seg = segments[s];
+				push(seg.eval((t - seg.t0) / (seg.t1 - seg.t0)));
+			}
+			return count;
+		}
+
+		// VBOߵĴСֻһΣ֮glBufferSubData׷Ĳ
+		void upload(GLuint VBO) {
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			size_t bytes = sizeof(float) * 3 * (countFor(1.0f) + 1);
+			if (capacity < bytes) {
+				capacity = bytes;
+				glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_DYNAMIC_DRAW);
+				uploaded = 0;
+			}
+			if (uploaded < size()) {
+				glBufferSubData(GL_ARRAY_BUFFER, sizeof(float) * 3 * uploaded,
+					sizeof(float) * 3 * (size() - uploaded), &vertices[(size_t)uploaded * 3]);
+				uploaded = size();
+			}
+		}
+
+	private:
+		size_t capacity = 0;
+		int uploaded = 0;   // ѾVBOĶ
+
+		void push(Point p) {
+			vertices.push_back(p.x);
+			vertices.push_back(p.y);
+			vertices.push_back(0.0f);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,208 @@
+#pragma once
+#ifndef _CURVE_FILE_H_
+#define _CURVE_FILE_H_
+
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include "Bezier.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Bezier {
+
+	using std::vector;
+
+	// ļʽСˣ
+	//   ļͷ CurveFileHeader
+	//   ƫƱ curveCount  CurveFileEntry
+	//    ÿߵĿƵδ x0 y0 x1 y1 ...float4ֽڶ
+	// ʱֻӳļļͷÿڱʱŽ룬Դ򿪺ʱļС޹
+	const char CURVE_FILE_MAGIC[4] = { 'B', 'Z', 'C', 'V' };
+	const uint32_t CURVE_FILE_VERSION = 1;
+
+	struct CurveFileHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t curveCount;
+		uint32_t reserved;
+		uint64_t tableOffset;    // ƫƱļͷλ
+	};
+
+	struct CurveFileEntry {
+		uint64_t offset;         // Ƶļͷλ
+		uint32_t pointCount;
+		uint32_t reserved;
+	};
+
+	// дļʧܷfalse
+	bool saveCurves(const char* path, const vector<vector<Point>>& curves) {
+		FILE* f = fopen(path, "wb");
+		if (!f) return false;
+
+		CurveFileHeader header;
+		memcpy(header.magic, CURVE_FILE_MAGIC, 4);
+		header.version = CURVE_FILE_VERSION;
+		header.curveCount = (uint32_t)curves.size();
+		header.reserved = 0;
+		header.tableOffset = sizeof(CurveFileHeader);
+
+		vector<CurveFileEntry> table(curves.size());
+		uint64_t offset = header.tableOffset + sizeof(CurveFileEntry) * curves.size();
+		for (size_t i = 0; i < curves.size(); i++) {
+			table[i].offset = offset;
+			table[i].pointCount = (uint32_t)curves[i].size();
+			table[i].reserved = 0;
+			offset += sizeof(float) * 2 * curves[i].size();
+		}
+
+		bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+		if (ok && !table.empty()) ok = fwrite(table.data(), sizeof(CurveFileEntry), table.size(), f) == table.size();
+		vector<float> packed;
+		for (size_t i = 0; ok && i < curves.size(); i++) {
+			packed.clear();
+			for (auto& p : curves[i]) {
+				packed.push_back(p.x);
+				packed.push_back(p.y);
+			}
+			if (!packed.empty()) ok = fwrite(packed.data(), sizeof(float), packed.size(), f) == packed.size();
+		}
+		return fclose(f) == 0 && ok;
+	}
+
+	// ֻӳһļ
+	class CurveFile {
+	public:
+		CurveFile() {}
+		~CurveFile() {
+			close();
+		}
+
+		// ӳļļͷƫƱķΧ
+		bool open(const char* path) {
+			close();
+#ifdef _WIN32
+			file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (file == INVALID_HANDLE_VALUE) return false;
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+				close();
+				return false;
+			}
+			bytes = (size_t)size.QuadPart;
+			mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (!mapping) {
+				close();
+				return false;
+			}
+			base = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+			fd = ::open(path, O_RDONLY);
+			if (fd < 0) return false;
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size == 0) {
+				close();
+				return false;
+			}
+			bytes = (size_t)st.st_size;
+			void* p = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+			base = p == MAP_FAILED ? NULL : (const char*)p;
+#endif
+			if (!base || !validHeader()) {
+				close();
+				return false;
+			}
+			return true;
+		}
+
+		void close() {
+#ifdef _WIN32
+			if (base) UnmapViewOfFile(base);
+			if (mapping) CloseHandle(mapping);
+			if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+			mapping = NULL;
+			file = INVALID_HANDLE_VALUE;
+#else
+			if (base) munmap((void*)base, bytes);
+			if (fd >= 0) ::close(fd);
+			fd = -1;
+#endif
+			base = NULL;
+			bytes = 0;
+		}
+
+		bool isOpen() const {
+			return base != NULL;
+		}
+
+		int size() const {
+			return base ? (int)header().curveCount : 0;
+		}
+
+		int pointCount(int i) const {
+			return validEntry(i) ? (int)entry(i).pointCount : 0;
+		}
+
+		// ֱָӳڴ x0 y0 x1 y1 ...ԽʱNULL
+		const float* data(int i) const {
+			return validEntry(i) ? (const float*)(base + entry(i).offset) : NULL;
+		}
+
+		// i
+		vector<Point> curve(int i) const {
+			vector<Point> ps;
+			const float* d = data(i);
+			if (!d) return ps;
+			int n = pointCount(i);
+			ps.reserve(n);
+			for (int k = 0; k < n; k++) ps.push_back(Point(d[k * 2], d[k * 2 + 1]));
+			return ps;
+		}
+
+	private:
+		const char* base = NULL;
+		size_t bytes = 0;
+#ifdef _WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = NULL;
+#else
+		int fd = -1;
+#endif
+
+		CurveFile(const CurveFile&);
+		CurveFile& operator=(const CurveFile&);
+
+		const CurveFileHeader& header() const {
+			return *(const CurveFileHeader*)base;
+		}
+
+		const CurveFileEntry& entry(int i) const {
+			return ((const CurveFileEntry*)(base + header().tableOffset))[i];
+		}
+
+		bool validHeader() const {
+			if (bytes < sizeof(CurveFileHeader)) return false;
+			const CurveFileHeader& h = header();
+			if (memcmp(h.magic, CURVE_FILE_MAGIC, 4) != 0 || h.version != CURVE_FILE_VERSION) return false;
+			if (h.tableOffset % 8 != 0 || h.tableOffset > bytes) return false;
+			return (bytes - h.tableOffset) / sizeof(CurveFileEntry) >= h.curveCount;
+		}
+
+		bool validEntry(int i) const {
+			if (!base || i < 0 || i >= size()) return false;
+			const CurveFileEntry& e = entry(i);
+			if (e.offset % 4 != 0 || e.offset > bytes) return false;
+			return (bytes - e.offset) / (sizeof(float) * 2) >= e.pointCount;
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,191 @@
+#pragma once
+#ifndef _CURVE_QUERY_H_
+#define _CURVE_QUERY_H_
+
+#include <vector>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include "Bezier.h"
+
+namespace Bezier {
+
+	using std::vector;
+
+	struct CurveHit {
+		int curve = -1;       // ѯʱеţ-1ʾû
+		float t = 0.0f;
+		Point p;              // ϵ
+		float dist = FLT_MAX;
+	};
+
+	// ߵİΧвΣƵ㷴de Casteljau԰֣ÿڵ¿ƵAABB
+	// ͹ʱ֤һ棩ƶ㹻ƽֱʱΪҶӡ
+	// Ƶ㲻ʱֻbuildһΣ֮ÿβѯֻſܸĽڵ
+	class CurveHierarchy {
+	public:
+		struct Node {
+			float t0, t1;
+			float minX, minY, maxX, maxY;
+			int child;        //  child, child + 1ҶΪ-1
+			Point a, b;       // Ҷӵңţٵһֵ
+		};
+
+		vector<Point> points;
+		vector<Point> hodograph;   // ߵĿƵ n * (P[i+1] - P[i])
+		vector<Node> nodes;
+
+		void build(const vector<Point>& ps, float flatness = 0.002f, int maxDepth = 10) {
+			points = ps;
+			nodes.clear();
+			hodograph.clear();
+			if (ps.empty()) return;
+			int n = (int)ps.size() - 1;
+			for (int i = 0; i < n; i++) {
+				hodograph.push_back(Point(n * (ps[i + 1].x - ps[i].x), n * (ps[i + 1].y - ps[i].y)));
+			}
+			nodes.push_back(Node());
+			split(0, ps, 0.0f, 1.0f, flatness, maxDepth);
+		}
+
+		// qߵ㣬볬maxDistĲ
+		// ҶӰAABBqľ֦ûҶԼţٵ
+		CurveHit nearest(Point q, float maxDist = FLT_MAX) const {
+			CurveHit hit;
+			if (nodes.empty()) return hit;
+			hit.dist = maxDist;
+			float best2 = maxDist < FLT_MAX ? maxDist * maxDist : FLT_MAX;
+			// ˵һϣսϽ
+			consider(0.0f, q, hit, best2);
+			consider(1.0f, q, hit, best2);
+
+			stack.clear();
+			stack.push_back(0);
+			while (!stack.empty()) {
+				const Node& node = nodes[stack.back()];
+				stack.pop_back();
+				if (boxDist2(node, q) > best2) continue;
+				if (node.child < 0) {
+					consider(refine(node, q), q, hit, best2);
+					continue;
+				}
+				// ĺӺѹջȱϽյø
+				int c0 = node.child, c1 = node.child + 1;
+				if (boxDist2(nodes[c0], q) < boxDist2(nodes[c1], q)) std::swap(c0, c1);
+				stack.push_back(c0);
+				stack.push_back(c1);
+			}
+			return hit;
+		}
+
+		// ڵAABBqľ룬ѯʱͼ֦
+		float lowerBound(Point q) const {
+			return nodes.empty() ? FLT_MAX : std::sqrt(boxDist2(nodes[0], q));
+		}
+
+	private:
+		// ѯõscratchͬһڶ߳ͬʱѯ
+		mutable DeCasteljau evaluator;
+		mutable vector<int> stack;
+
+		void split(int index, const vector<Point>& ps, float t0, float t1, float flatness, int depth) {
+			Node node;
+			node.t0 = t0;
+			node.t1 = t1;
+			node.minX = node.maxX = ps[0].x;
+			node.minY = node.maxY = ps[0].y;
+			for (auto& p : ps) {
+				node.minX = (std::min)(node.minX, p.x);
+				node.maxX = (std::max)(node.maxX, p.x);
+				node.minY = (std::min)(node.minY, p.y);
+				node.maxY = (std::max)(node.maxY, p.y);
+			}
+			node.a = ps.front();
+			node.b = ps.back();
+			node.child = -1;
+
+			if (depth <= 0 || ps.size() < 3 || flatnessOf(ps) <= flatness) {
+				nodes[index] = node;
+				return;
+			}
+
+			vector<Point> left, right;
+			splitHalf(ps, left, right);
+
+			node.child = (int)nodes.size();
+			nodes[index] = node;
+			nodes.resize(nodes.size() + 2);
+			float m = (t0 + t1) / 2;
+			split(node.child, left, t0, m, flatness, depth - 1);
+			split(node.child + 1, right, m, t1, flatness, depth - 1);
+		}
+
+		static float boxDist2(const Node& node, Point q) {
+			float dx = (std::max)((std::max)(node.minX - q.x, q.x - node.maxX), 0.0f);
+			float dy = (std::max)((std::max)(node.minY - q.y, q.y - node.maxY), 0.0f);
+			return dx * dx + dy * dy;
+		}
+
+		// ȰqͶӰҶӵϵõֵٶ f(t) = (B(t) - q)  B'(t) ţٵ
+		float refine(const Node& node, Point q) const {
+			float dx = node.b.x - node.a.x, dy = node.b.y - node.a.y;
+			float len2 = dx * dx + dy * dy;
+			float u = len2 > 0 ? ((q.x - node.a.x) * dx + (q.y - node.a.y) * dy) / len2 : 0.0f;
+			float t = node.t0 + (node.t1 - node.t0) * (std::min)((std::max)(u, 0.0f), 1.0f);
+			if (hodograph.empty()) return t;
+			for (int it = 0; it < 4; it++) {
+				Point d, dd;
+				Point p = evaluator.eval(points, t);
+				d = evaluator.eval(hodograph, t, &dd);
+				float ex = p.x - q.x, ey = p.y - q.y;
+				float f = ex * d.x + ey * d.y;
+				float df = d.x * d.x + d.y * d.y + ex * dd.x + ey * dd.y;
+				if (df <= 1e-12f) break;
+				float next = (std::min)((std::max)(t - f / df, node.t0), node.t1);
+				if (std::abs(next - t) < 1e-6f) {
+					t = next;
+					break;
+				}
+				t = next;
+			}
+			return t;
+		}
+
+		void consider(float t, Point q, CurveHit& hit, float& best2) const {
+			Point p = evaluator.eval(points, t);
+			float d2 = (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y);
+			if (d2 <= best2) {
+				best2 = d2;
+				hit.curve = 0;
+				hit.t = t;
+				hit.p = p;
+				hit.dist = std::sqrt(d2);
+			}
+		}
+	};
+
+	// 汾qһ
+	// ȰڵAABBľбĳߵ½绹ʱĶÿ
+	CurveHit nearestCurve(const vector<CurveHierarchy>& curves, Point q, float maxDist = FLT_MAX) {
+		vector<std::pair<float, int>> order;
+		for (size_t i = 0; i < curves.size(); i++) {
+			float bound = curves[i].lowerBound(q);
+			if (bound <= maxDist) order.push_back(std::make_pair(bound, (int)i));
+		}
+		std::sort(order.begin(), order.end());
+
+		CurveHit best;
+		best.dist = maxDist;
+		for (auto& o : order) {
+			if (o.first > best.dist) break;
+			CurveHit hit = curves[o.second].nearest(q, best.dist);
+			if (hit.curve >= 0) {
+				best = hit;
+				best.curve = o.second;
+			}
+		}
+		return best;
+	}
+}
+
+#endif
@@ -0,0 +1,207 @@
+#pragma once
+#ifndef _INTERSECT_H_
+#define _INTERSECT_H_
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+#include "Bezier.h"
+#include "Bounds.h"
+
+namespace Bezier {
+
+	using std::vector;
+
+	// 㣺tΪһϵĲuΪڶߣ߶ΣϵĲ
+	struct Intersection {
+		float t, u;
+		Point p;
+	};
+
+	// 󽻵Ľa < b Ϊߵı
+	struct CurvePairIntersection {
+		int a, b;
+		float t, u;
+		Point p;
+	};
+
+	namespace detail {
+		AABB controlBox(const vector<Point>& ps) {
+			AABB box;
+			for (auto& p : ps) box.extend(p);
+			return box;
+		}
+
+		// ߶ a0a1  b0b1 Ľƽлཻfalse
+		bool segmentIntersect(Point a0, Point a1, Point b0, Point b1, float& s, float& r) {
+			float dax = a1.x - a0.x, day = a1.y - a0.y;
+			float dbx = b1.x - b0.x, dby = b1.y - b0.y;
+			float den = dax * dby - day * dbx;
+			if (std::abs(den) < 1e-12f) return false;
+			float ex = b0.x - a0.x, ey = b0.y - a0.y;
+			s = (ex * dby - ey * dbx) / den;
+			r = (ex * day - ey * dax) / den;
+			// ˵㴦һϸֱ߽ʱ߶©
+			const float eps = 1e-4f;
+			return s >= -eps && s <= 1 + eps && r >= -eps && r <= 1 + eps;
+		}
+
+		struct Piece {
+			vector<Point> a, b;
+			float t0, t1, u0, u1;
+			int depth;
+		};
+	}
+
+	// BezierߵĽ㣬ݹϸ֣
+	// ƵΧвཻһֱӶ㹻ƽֱʱ߶󽻣ţٵ A(t) = B(u) ս
+	// ѰΧнϴһ԰֡
+	// flatnessǿռ루ͬλϸֵƽֱŰ߶󽻣
+	// paramEpsilonǲռţٵԽεtu10paramEpsilonʱֻһ
+	// ߷ֿflatnessֻϸָ֣tĲͬϲ
+	vector<Intersection> intersect(const vector<Point>& a, const vector<Point>& b, float flatness = 1e-4f, float paramEpsilon = 1e-4f, int maxDepth = 32) {
+		vector<Intersection> result;
+		if (a.size() < 2 || b.size() < 2) return result;
+
+		DeCasteljau evalA, evalB;
+		vector<detail::Piece> stack;
+		stack.push_back(detail::Piece{ a, b, 0.0f, 1.0f, 0.0f, 1.0f, 0 });
+		while (!stack.empty()) {
+			detail::Piece piece = std::move(stack.back());
+			stack.pop_back();
+
+			AABB boxA = detail::controlBox(piece.a), boxB = detail::controlBox(piece.b);
+			if (!boxA.intersects(boxB)) continue;
+
+			bool flatA = flatnessOf(piece.a) <= flatness;
+			bool flatB = flatnessOf(piece.b) <= flatness;
+			if ((flatA && flatB) || piece.depth >= maxDepth) {
+				float s, r;
+				if (!detail::segmentIntersect(piece.a.front(), piece.a.back(), piece.b.front(), piece.b.back(), s, r)) continue;
+				s = (std::min)((std::max)(s, 0.0f), 1.0f);
+				r = (std::min)((std::max)(r, 0.0f), 1.0f);
+				float t = piece.t0 + (piece.t1 - piece.t0) * s;
+				float u = piece.u0 + (piece.u1 - piece.u0) * r;
+
+				// ţٵF(t, u) = A(t) - B(u)ſɱΪ [A'(t), -B'(u)]
+				for (int it = 0; it < 4; it++) {
+					Point da, db;
+					Point pa = evalA.eval(a, t, &da), pb = evalB.eval(b, u, &db);
+					float fx = pa.x - pb.x, fy = pa.y - pb.y;
+					float det = -da.x * db.y + da.y * db.x;
+					if (std::abs(det) < 1e-12f) break;
+					float dt = (-db.y * fx + db.x * fy) / det;
+					float du = (-da.y * fx + da.x * fy) / det;
+					float nt = t - dt, nu = u - du;
+					// ξͲɣ߶󽻵Ľ
+					if (nt < piece.t0 - paramEpsilon || nt > piece.t1 + paramEpsilon || nu < piece.u0 - paramEpsilon || nu > piece.u1 + paramEpsilon) break;
+					t = (std::min)((std::max)(nt, 0.0f), 1.0f);
+					u = (std::min)((std::max)(nu, 0.0f), 1.0f);
+					if (std::abs(dt) + std::abs(du) < 1e-7f) break;
+				}
+
+				bool duplicate = false;
+				for (auto& hit : result) {
+					if (std::abs(hit.t - t) <= paramEpsilon * 10 && std::abs(hit.u - u) <= paramEpsilon * 10) {
+						duplicate = true;
+						break;
+					}
+				}
+				if (!duplicate) result.push_back(Intersection{ t, u, evalA.eval(a, t) });
+				continue;
+			}
+
+			// ִʱ
+			float sizeA = (std::max)(boxA.maxX - boxA.minX, boxA.maxY - boxA.minY);
+			float sizeB = (std::max)(boxB.maxX - boxB.minX, boxB.maxY - boxB.minY);
+			bool splitA = !flatA && (flatB || sizeA >= sizeB);
+			vector<Point> left, right;
+			if (splitA) {
+				splitHalf(piece.a, left, right);
+				float m = (piece.t0 + piece.t1) / 2;
+				stack.push_back(detail::Piece{ right, piece.b, m, piece.t1, piece.u0, piece.u1, piece.depth + 1 });
+				stack.push_back(detail::Piece{ left, piece.b, piece.t0, m, piece.u0, piece.u1, piece.depth + 1 });
+			} else {
+				splitHalf(piece.b, left, right);
+				float m = (piece.u0 + piece.u1) / 2;
+				stack.push_back(detail::Piece{ piece.a, right, piece.t0, piece.t1, m, piece.u1, piece.depth + 1 });
+				stack.push_back(detail::Piece{ piece.a, left, piece.t0, piece.t1, piece.u0, m, piece.depth + 1 });
+			}
+		}
+
+		std::sort(result.begin(), result.end(), [](const Intersection& x, const Intersection& y) {
+			return x.t < y.t;
+		});
+		return result;
+	}
+
+	// ߶ p0p1 󽻣߶ε1BezierߣuΪ߶ϵĲ
+	vector<Intersection> intersectLine(const vector<Point>& a, Point p0, Point p1, float flatness = 1e-4f, float paramEpsilon = 1e-4f) {
+		vector<Point> line;
+		line.push_back(p0);
+		line.push_back(p1);
+		return intersect(a, line, flatness, paramEpsilon);
+	}
+
+	// 󽻣Խ
+	// ɸ߰ΧзŽֻͬһҰΧཻ߲ϸ㡣
+	// һ߿ͬʱںüֻΧн½ڵĸһ
+	vector<CurvePairIntersection> intersectAll(const vector<vector<Point>>& curves, float flatness = 1e-4f, float paramEpsilon = 1e-4f) {
+		vector<CurvePairIntersection> result;
+		int n = (int)curves.size();
+		vector<AABB> boxes(n);
+		AABB all;
+		float extent = 0;
+		int valid = 0;
+		for (int i = 0; i < n; i++) {
+			if (curves[i].size() < 2) continue;
+			boxes[i] = tightBounds(curves[i]);
+			all.extend(Point(boxes[i].minX, boxes[i].minY));
+			all.extend(Point(boxes[i].maxX, boxes[i].maxY));
+			extent += (std::max)(boxes[i].maxX - boxes[i].minX, boxes[i].maxY - boxes[i].minY);
+			valid++;
+		}
+		if (valid < 2) return result;
+
+		// ȡߵƽСֳ64x64
+		float cellSize = extent / valid;
+		cellSize = (std::max)(cellSize, (std::max)(all.maxX - all.minX, all.maxY - all.minY) / 64);
+		if (cellSize <= 0) cellSize = 1.0f;
+		auto cellOf = [&](float v) {
+			return (int)std::floor(v / cellSize);
+		};
+		auto key = [](int x, int y) {
+			return ((long long)x << 32) ^ (unsigned int)y;
+		};
+
+		std::unordered_map<long long, vector<int>> grid;
+		for (int i = 0; i < n; i++) {
+			if (boxes[i].empty()) continue;
+			for (int x = cellOf(boxes[i].minX); x <= cellOf(boxes[i].maxX); x++)
+				for (int y = cellOf(boxes[i].minY); y <= cellOf(boxes[i].maxY); y++)
+					grid[key(x, y)].push_back(i);
+		}
+
+		for (auto& cell : grid) {
+			const vector<int>& ids = cell.second;
+			for (size_t i = 0; i < ids.size(); i++) {
+				for (size_t j = i + 1; j < ids.size(); j++) {
+					const AABB& A = boxes[ids[i]];
+					const AABB& B = boxes[ids[j]];
+					if (!A.intersects(B)) continue;
+					float ox = (std::max)(A.minX, B.minX), oy = (std::max)(A.minY, B.minY);
+					if (key(cellOf(ox), cellOf(oy)) != cell.first) continue;
+
+					int a = (std::min)(ids[i], ids[j]), b = (std::max)(ids[i], ids[j]);
+					for (auto& hit : intersect(curves[a], curves[b], flatness, paramEpsilon)) {
+						result.push_back(CurvePairIntersection{ a, b, hit.t, hit.u, hit.p });
+					}
+				}
+			}
+		}
+		return result;
+	}
+}
+
+#endif
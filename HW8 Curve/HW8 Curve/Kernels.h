@@ -0,0 +1,128 @@
+#pragma once
+#ifndef _KERNELS_H_
+#define _KERNELS_H_
+
+#include <vector>
+#include "Bezier.h"
+
+namespace Bezier {
+
+	using std::vector;
+
+	// ڶʽϵ
+	constexpr int binomial(int n, int k) {
+		return k < 0 || k > n ? 0 : (k == 0 || k == n ? 1 : binomial(n - 1, k - 1) + binomial(n - 1, k));
+	}
+
+	constexpr int signOf(int k) {
+		return k % 2 == 0 ? 1 : -1;
+	}
+
+	// ؾأHornerչa[J] + t * (a[J+1] + t * (... + t * a[N]))ģݹ鱣֤ȫչ
+	template<int N, int J>
+	struct Horner {
+		static float eval(const float* a, float t) {
+			return a[J] + t * Horner<N, J + 1>::eval(a, t);
+		}
+	};
+
+	template<int N>
+	struct Horner<N, N> {
+		static float eval(const float* a, float /*t*/) {
+			return a[N];
+		}
+	};
+
+	// ݻϵĵjC(N, j) * sum_i (-1)^(j-i) C(j, i) P_iijǱڳ
+	template<int N, int J, int I>
+	struct PowerTerm {
+		static float x(const Point* ps) {
+			return signOf(J - I) * binomial(J, I) * ps[I].x + PowerTerm<N, J, I - 1>::x(ps);
+		}
+		static float y(const Point* ps) {
+			return signOf(J - I) * binomial(J, I) * ps[I].y + PowerTerm<N, J, I - 1>::y(ps);
+		}
+	};
+
+	template<int N, int J>
+	struct PowerTerm<N, J, -1> {
+		static float x(const Point*) { return 0.0f; }
+		static float y(const Point*) { return 0.0f; }
+	};
+
+	template<int N, int J>
+	struct PowerCoefficients {
+		static void build(const Point* ps, float* ax, float* ay) {
+			ax[J] = binomial(N, J) * PowerTerm<N, J, J>::x(ps);
+			ay[J] = binomial(N, J) * PowerTerm<N, J, J>::y(ps);
+			PowerCoefficients<N, J - 1>::build(ps, ax, ay);
+		}
+	};
+
+	template<int N>
+	struct PowerCoefficients<N, -1> {
+		static void build(const Point*, float*, float*) {}
+	};
+
+	// NȻݻ a0 + a1 t + ... + aN t^NÿֻҪNγ˼
+	// ֻڵͽף߽ݻϵ໥أȲ
+	template<int N>
+	struct FixedCurve {
+		float ax[N + 1], ay[N + 1];
+
+		explicit FixedCurve(const Point* ps) {
+			PowerCoefficients<N, N>::build(ps, ax, ay);
+		}
+
+		Point eval(float t) const {
+			return Point(Horner<N, 0>::eval(ax, t), Horner<N, 0>::eval(ay, t));
+		}
+
+		// k t = k * dtkfromto - 1ÿ3floatдout
+		void sample(int from, int to, float dt, float* out) const {
+			for (int k = from; k < to; k++, out += 3) {
+				float t = k * dt;
+				out[0] = Horner<N, 0>::eval(ax, t);
+				out[1] = Horner<N, 0>::eval(ay, t);
+				out[2] = 0.0f;
+			}
+		}
+	};
+
+	const int MAX_FIXED_DEGREE = 5;
+
+	// Ƶѡػ汾15FixedCurve߽˻de Casteljau
+	void sampleRange(const vector<Point>& ps, int from, int to, float dt, float* out) {
+		switch ((int)ps.size() - 1) {
+		case 1: FixedCurve<1>(ps.data()).sample(from, to, dt, out); return;
+		case 2: FixedCurve<2>(ps.data()).sample(from, to, dt, out); return;
+		case 3: FixedCurve<3>(ps.data()).sample(from, to, dt, out); return;
+		case 4: FixedCurve<4>(ps.data()).sample(from, to, dt, out); return;
+		case 5: FixedCurve<5>(ps.data()).sample(from, to, dt, out); return;
+		default: break;
+		}
+		DeCasteljau evaluator;
+		for (int k = from; k < to; k++, out += 3) {
+			Point p = ps.empty() ? Point() : evaluator.eval(ps, k * dt);
+			out[0] = p.x;
+			out[1] = p.y;
+			out[2] = 0.0f;
+		}
+	}
+
+	// ֵķɰ汾ҪͬһܶʱsampleRange
+	Point evalFixed(const vector<Point>& ps, float t) {
+		switch ((int)ps.size() - 1) {
+		case 1: return FixedCurve<1>(ps.data()).eval(t);
+		case 2: return FixedCurve<2>(ps.data()).eval(t);
+		case 3: return FixedCurve<3>(ps.data()).eval(t);
+		case 4: return FixedCurve<4>(ps.data()).eval(t);
+		case 5: return FixedCurve<5>(ps.data()).eval(t);
+		default: break;
+		}
+		DeCasteljau evaluator;
+		return ps.empty() ? Point() : evaluator.eval(ps, t);
+	}
+}
+
+#endif
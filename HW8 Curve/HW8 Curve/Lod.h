@@ -0,0 +1,107 @@
+#pragma once
+#ifndef _LOD_H_
+#define _LOD_H_
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <glad/glad.h>
+#include "Bezier.h"
+
+namespace Bezier {
+
+	using std::vector;
+
+	// ĻϵĴС߲ǹ̶ 1 / deltaT
+	// ȡ2ΪLODÿһĲлʱ¼
+	class LodCache {
+	public:
+		float tolerance = 0.5f;   // ߵƫλ
+		int maxLevel = 12;        //  2^12 
+
+		void invalidate() {
+			levels.clear();
+			uploadedLevel = -1;
+		}
+
+		// ƶĻϵĳȣأ߳Ȳᳬ
+		// scaleX, scaleY ΪÿλӦ
+		static float projectedLength(const vector<Point>& ps, float scaleX, float scaleY) {
+			float len = 0;
+			for (size_t i = 1; i < ps.size(); i++) {
+				float dx = (ps[i].x - ps[i - 1].x) * scaleX, dy = (ps[i].y - ps[i - 1].y) * scaleY;
+				len += std::sqrt(dx * dx + dy * dy);
+			}
+			return len;
+		}
+
+		// ȲNߵ |B''|max / (8 N^2)
+		//  |B''| <= n(n-1) * max|P[i+2] - 2P[i+1] + P[i]|
+		//  N = sqrt(n(n-1) * M / (8 * tolerance)) 
+		// ÿβضһأÿƶγȷⶥ
+		int segmentCount(const vector<Point>& ps, float scaleX, float scaleY) const {
+			int n = (int)ps.size() - 1;
+			if (n < 2) return 1;
+			float M = 0;
+			for (int i = 0; i + 2 <= n; i++) {
+				float dx = (ps[i + 2].x - 2 * ps[i + 1].x + ps[i].x) * scaleX;
+				float dy = (ps[i + 2].y - 2 * ps[i + 1].y + ps[i].y) * scaleY;
+				M = (std::max)(M, std::sqrt(dx * dx + dy * dy));
+			}
+			float byError = std::sqrt(n * (n - 1) * M / (8 * tolerance));
+			float byLength = projectedLength(ps, scaleX, scaleY);
+			return (std::max)(1, (int)std::ceil((std::min)(byError, byLength)));
+		}
+
+		// ȡ2
+		int levelFor(int segments) const {
+			int level = 0;
+			while ((1 << level) < segments && level < maxLevel) level++;
+			return level;
+		}
+
+		// ǰӦʹõļĲ㣬ÿ3float 2^level + 1 
+		// cubicΪʱڷֶνȡ㣬԰ԭƵ
+		const vector<float>& vertices(const vector<Point>& ps, float scaleX, float scaleY, const vector<CubicSegment>& cubic = vector<CubicSegment>()) {
+			current = levelFor(segmentCount(ps, scaleX, scaleY));
+			if ((int)levels.size() <= current) levels.resize(current + 1);
+			vector<float>& v = levels[current];
+			if (v.empty() && !ps.empty()) {
+				int segments = 1 << current;
+				v.reserve((size_t)(segments + 1) * 3);
+				for (int k = 0; k <= segments; k++) {
+					float t = (float)k / segments;
+					Point p = cubic.empty() ? evaluator.eval(ps, t) : evalPiecewise(cubic, t);
+					v.push_back(p.x);
+					v.push_back(p.y);
+					v.push_back(0.0f);
+				}
+			}
+			return v;
+		}
+
+		int level() const {
+			return current;
+		}
+
+		int segments() const {
+			return 1 << current;
+		}
+
+		// ˲ϴ
+		void upload(GLuint VBO) {
+			if (uploadedLevel == current || (int)levels.size() <= current) return;
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * levels[current].size(), levels[current].data(), GL_DYNAMIC_DRAW);
+			uploadedLevel = current;
+		}
+
+	private:
+		vector<vector<float>> levels;   // ձʾһû
+		DeCasteljau evaluator;
+		int current = 0;
+		int uploadedLevel = -1;
+	};
+}
+
+#endif
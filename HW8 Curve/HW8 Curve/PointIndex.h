@@ -0,0 +1,161 @@
+#pragma once
+#ifndef _POINT_INDEX_H_
+#define _POINT_INDEX_H_
+
+#include <vector>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <unordered_map>
+#include "Bezier.h"
+
+namespace Bezier {
+
+	using std::vector;
+
+	// Ƶľʰȡɾ϶
+	// ÿһidӱ߳ȡʰȡ뾶ʱ
+	// ѯƽֻΧӣɾƶO(1)
+	class PointIndex {
+	public:
+		PointIndex(float cellSize_ = 0.02f) : cellSize(cellSize_) {}
+
+		void clear() {
+			cells.clear();
+			positions.clear();
+		}
+
+		int size() const {
+			return (int)positions.size();
+		}
+
+		void insert(int id, Point p) {
+			positions[id] = p;
+			cells[key(cellOf(p.x), cellOf(p.y))].push_back(id);
+			if (positions.size() == 1) {
+				minX = maxX = cellOf(p.x);
+				minY = maxY = cellOf(p.y);
+			} else {
+				minX = (std::min)(minX, cellOf(p.x));
+				maxX = (std::max)(maxX, cellOf(p.x));
+				minY = (std::min)(minY, cellOf(p.y));
+				maxY = (std::max)(maxY, cellOf(p.y));
+			}
+		}
+
+		void remove(int id) {
+			auto it = positions.find(id);
+			if (it == positions.end()) return;
+			Point p = it->second;
+			positions.erase(it);
+			auto cell = cells.find(key(cellOf(p.x), cellOf(p.y)));
+			if (cell == cells.end()) return;
+			vector<int>& ids = cell->second;
+			for (size_t i = 0; i < ids.size(); i++) {
+				if (ids[i] == id) {
+					ids[i] = ids.back();
+					ids.pop_back();
+					break;
+				}
+			}
+			if (ids.empty()) cells.erase(cell);
+		}
+
+		void move(int id, Point p) {
+			auto it = positions.find(id);
+			if (it != positions.end() && cellOf(it->second.x) == cellOf(p.x) && cellOf(it->second.y) == cellOf(p.y)) {
+				it->second = p;
+				return;
+			}
+			remove(id);
+			insert(id, p);
+		}
+
+		// pҾ벻maxDistĵ㣬û򷵻-1
+		// pڸһȦȦңĳһȦܾѾǰžֹͣ
+		int nearest(Point p, float maxDist = FLT_MAX) const {
+			if (positions.empty()) return -1;
+			int cx = cellOf(p.x), cy = cellOf(p.y);
+			int best = -1;
+			float bestD2 = maxDist < FLT_MAX ? maxDist * maxDist : FLT_MAX;
+			// ΧоûҪ
+			int maxRing = (std::max)((std::max)(std::abs(cx - minX), std::abs(cx - maxX)),
+				(std::max)(std::abs(cy - minY), std::abs(cy - maxY)));
+			if (maxDist < FLT_MAX)
+				maxRing = (std::min)(maxRing, (int)std::ceil(maxDist / cellSize));
+
+			for (int r = 0; r <= maxRing; r++) {
+				// rȦϵĵp (r - 1) * cellSize Զ
+				float ringDist = (r - 1) * cellSize;
+				if (r > 1 && ringDist * ringDist > bestD2) break;
+				auto check = [&](int id, const Point& q) {
+					float d2 = dist2(p, q);
+					if (d2 <= bestD2) {
+						bestD2 = d2;
+						best = id;
+					}
+				};
+				if (r == 0) {
+					visit(cx, cy, check);
+					continue;
+				}
+				// ֻߵrȦıߣУУȥ߹Ľǣ
+				for (int x = cx - r; x <= cx + r; x++) {
+					visit(x, cy - r, check);
+					visit(x, cy + r, check);
+				}
+				for (int y = cy - r + 1; y <= cy + r - 1; y++) {
+					visit(cx - r, y, check);
+					visit(cx + r, y, check);
+				}
+			}
+			return best;
+		}
+
+		// pradiusе
+		vector<int> radius(Point p, float r) const {
+			vector<int> result;
+			int x0 = cellOf(p.x - r), x1 = cellOf(p.x + r);
+			int y0 = cellOf(p.y - r), y1 = cellOf(p.y + r);
+			for (int x = x0; x <= x1; x++) {
+				for (int y = y0; y <= y1; y++) {
+					visit(x, y, [&](int id, const Point& q) {
+						if (dist2(p, q) <= r * r) result.push_back(id);
+					});
+				}
+			}
+			return result;
+		}
+
+		Point position(int id) const {
+			return positions.at(id);
+		}
+
+	private:
+		float cellSize;
+		std::unordered_map<long long, vector<int>> cells;
+		std::unordered_map<int, Point> positions;
+		int minX = 0, maxX = 0, minY = 0, maxY = 0;
+
+		int cellOf(float v) const {
+			return (int)std::floor(v / cellSize);
+		}
+
+		static long long key(int x, int y) {
+			return ((long long)x << 32) ^ (unsigned int)y;
+		}
+
+		static float dist2(const Point& a, const Point& b) {
+			return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+		}
+
+		template<typename F>
+		void visit(int x, int y, F f) const {
+			auto cell = cells.find(key(x, y));
+			if (cell == cells.end()) return;
+			for (int id : cell->second) f(id, positions.at(id));
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,240 @@
+#pragma once
+#ifndef _STROKE_H_
+#define _STROKE_H_
+
+#include <vector>
+#include <cmath>
+#include <functional>
+#include <algorithm>
+#include <glad/glad.h>
+#include "Bezier.h"
+
+namespace Stroke {
+
+	using std::vector;
+	using Bezier::Point;
+
+	enum Join { MITER, ROUND, BEVEL };
+	enum Cap { BUTT, SQUARE, ROUND_CAP };
+
+	struct Style {
+		float width = 0.01f;      // ߿ͬλ
+		Join join = MITER;
+		Cap cap = BUTT;
+		float miterLimit = 4.0f;  // ǳȳ miterLimit * width / 2 ʱ˻bevel
+		float roundStep = 0.3f;   // Բ/ԲñÿεĽǶȣȣ
+	};
+
+	namespace detail {
+
+		// eval(t)ϵĵ㣬߱ʾͬһϸ
+		template<typename Eval>
+		vector<Point> flatten(Eval eval, float tolerance, float t0, float t1, int maxDepth) {
+			vector<Point> line;
+			if (t1 <= t0) return line;
+
+			std::function<void(float, Point, float, Point, int)> split = [&](float a, Point pa, float b, Point pb, int depth) {
+				float m = (a + b) / 2;
+				Point pm = eval(m);
+				// ٿ1/43/4Sеǡ
+				Point q1 = eval((a + m) / 2), q3 = eval((m + b) / 2);
+				float dx = pb.x - pa.x, dy = pb.y - pa.y;
+				float len = std::sqrt(dx * dx + dy * dy);
+				auto dist = [&](Point q) {
+					if (len < 1e-12f) return std::sqrt((q.x - pa.x) * (q.x - pa.x) + (q.y - pa.y) * (q.y - pa.y));
+					return std::abs((q.x - pa.x) * dy - (q.y - pa.y) * dx) / len;
+				};
+				float err = (std::max)(dist(pm), (std::max)(dist(q1), dist(q3)));
+				if (depth >= maxDepth || (depth >= 2 && err <= tolerance)) {
+					line.push_back(pb);
+					return;
+				}
+				split(a, pa, m, pm, depth + 1);
+				split(m, pm, b, pb, depth + 1);
+			};
+
+			Point p0 = eval(t0);
+			line.push_back(p0);
+			split(t0, p0, t1, eval(t1), 0);
+			return line;
+		}
+	}
+
+	// ӦչƽеƫҵľСtoleranceͲϸ֣
+	// ֱֻ߲㣬żܣԶڹ̶1000
+	vector<Point> flatten(const vector<Point>& ps, float tolerance = 0.001f, float t0 = 0.0f, float t1 = 1.0f, int maxDepth = 16) {
+		if (ps.size() < 2) return vector<Point>();
+		Bezier::DeCasteljau evaluator;
+		return detail::flatten([&](float t) { return evaluator.eval(ps, t); }, tolerance, t0, t1, maxDepth);
+	}
+
+	// ֶνƣBezier::toPiecewiseCubicİ汾tԭߵĲ
+	vector<Point> flatten(const vector<Bezier::CubicSegment>& segments, float tolerance = 0.001f, float t0 = 0.0f, float t1 = 1.0f, int maxDepth = 16) {
+		if (segments.empty()) return vector<Point>();
+		return detail::flatten([&](float t) { return Bezier::evalPiecewise(segments, t); }, tolerance, t0, t1, maxDepth);
+	}
+
+	// ߱ɴδ(GL_TRIANGLE_STRIP)
+	// ÿ3floatתڲĵֻһΣ
+	class Stroker {
+	public:
+		vector<float> vertices;
+		vector<unsigned int> indices;
+
+		void stroke(const vector<Point>& line, const Style& style) {
+			vertices.clear();
+			indices.clear();
+
+			// ȥغϵĵ
+			pts.clear();
+			for (auto& p : line) {
+				if (pts.empty() || std::abs(p.x - pts.back().x) + std::abs(p.y - pts.back().y) > 1e-7f) pts.push_back(p);
+			}
+			if (pts.size() < 2) return;
+
+			float h = style.width / 2;
+			int n = (int)pts.size();
+
+			// 
+			Point d = dir(0), nrm(-d.y, d.x);
+			startCap(pts[0], d, nrm, h, style);
+
+			for (int i = 1; i < n - 1; i++) {
+				Point d0 = dir(i - 1), d1 = dir(i);
+				join(pts[i], d0, d1, h, style, segLen(i - 1), segLen(i));
+			}
+
+			d = dir(n - 2);
+			nrm = Point(-d.y, d.x);
+			endCap(pts[n - 1], d, nrm, h, style);
+		}
+
+		// ϴVAOһglDrawElementsл
+		void bind(GLuint VAO, GLuint VBO, GLuint EBO) {
+			glBindVertexArray(VAO);
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertices.size(), vertices.data(), GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indices.size(), indices.data(), GL_DYNAMIC_DRAW);
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+			glEnableVertexAttribArray(0);
+		}
+
+		void draw(GLuint VAO) {
+			glBindVertexArray(VAO);
+			glDrawElements(GL_TRIANGLE_STRIP, (GLsizei)indices.size(), GL_UNSIGNED_INT, 0);
+		}
+
+	private:
+		vector<Point> pts;
+
+		Point dir(int i) {
+			float dx = pts[i + 1].x - pts[i].x, dy = pts[i + 1].y - pts[i].y;
+			float len = std::sqrt(dx * dx + dy * dy);
+			return Point(dx / len, dy / len);
+		}
+
+		float segLen(int i) {
+			float dx = pts[i + 1].x - pts[i].x, dy = pts[i + 1].y - pts[i].y;
+			return std::sqrt(dx * dx + dy * dy);
+		}
+
+		unsigned int add(Point p) {
+			vertices.push_back(p.x);
+			vertices.push_back(p.y);
+			vertices.push_back(0.0f);
+			return (unsigned int)(vertices.size() / 3 - 1);
+		}
+
+		// δʼհ (, ) ɶ׷
+		void pair(unsigned int l, unsigned int r) {
+			indices.push_back(l);
+			indices.push_back(r);
+		}
+
+		static Point offset(Point p, Point v, float s) {
+			return Point(p.x + v.x * s, p.y + v.y * s);
+		}
+
+		void startCap(Point p, Point d, Point n, float h, const Style& style) {
+			if (style.cap == SQUARE) p = offset(p, d, -h);
+			if (style.cap == ROUND_CAP) {
+				// ԲӱĶ㿪ʼҶԳչ
+				int steps = (std::max)(1, (int)std::ceil(1.5707963f / style.roundStep));
+				for (int k = 0; k < steps; k++) {
+					float a = 1.5707963f * k / steps;
+					Point back = offset(p, d, -h * std::cos(a));
+					pair(add(offset(back, n, h * std::sin(a))), add(offset(back, n, -h * std::sin(a))));
+				}
+			}
+			pair(add(offset(p, n, h)), add(offset(p, n, -h)));
+		}
+
+		void endCap(Point p, Point d, Point n, float h, const Style& style) {
+			if (style.cap == SQUARE) p = offset(p, d, h);
+			pair(add(offset(p, n, h)), add(offset(p, n, -h)));
+			if (style.cap == ROUND_CAP) {
+				int steps = (std::max)(1, (int)std::ceil(1.5707963f / style.roundStep));
+				for (int k = steps - 1; k >= 0; k--) {
+					float a = 1.5707963f * k / steps;
+					Point front = offset(p, d, h * std::cos(a));
+					pair(add(offset(front, n, h * std::sin(a))), add(offset(front, n, -h * std::sin(a))));
+				}
+			}
+		}
+
+		void join(Point p, Point d0, Point d1, float h, const Style& style, float len0, float len1) {
+			Point n0(-d0.y, d0.x), n1(-d1.y, d1.x);
+			float cross = d0.x * d1.y - d0.y * d1.x;
+			float dot = d0.x * d1.x + d0.y * d1.y;
+
+			// ߣֱһԵ
+			if (std::abs(cross) < 1e-6f && dot > 0) {
+				pair(add(offset(p, n0, h)), add(offset(p, n0, -h)));
+				return;
+			}
+
+			// ƽַϵļǵ㣬miterScaleΪǵĵĳ
+			Point m(n0.x + n1.x, n0.y + n1.y);
+			float mlen = std::sqrt(m.x * m.x + m.y * m.y);
+			float cosHalf = mlen / 2;
+			float miterScale = cosHalf > 1e-4f ? h / cosHalf : 1e30f;
+			if (mlen > 1e-6f) m = Point(m.x / mlen, m.y / mlen);
+
+			// תʱұ(side = -1)תʱ
+			float side = cross > 0 ? -1.0f : 1.0f;
+
+			if (style.join == MITER && miterScale <= style.miterLimit * h) {
+				pair(add(offset(p, m, miterScale)), add(offset(p, m, -miterScale)));
+				return;
+			}
+
+			// ڲȡǽ㣬̫(߶κܶ)ʱ˻ĵ
+			Point inner = miterScale <= (std::min)(len0, len1) ? offset(p, m, -side * miterScale) : p;
+			unsigned int innerIdx = add(inner);
+
+			Point o0 = offset(p, n0, side * h), o1 = offset(p, n1, side * h);
+			vector<Point> arc;
+			arc.push_back(o0);
+			if (style.join == ROUND) {
+				float angle = std::acos((std::max)(-1.0f, (std::min)(1.0f, dot)));
+				int steps = (int)std::ceil(angle / style.roundStep);
+				float a0 = std::atan2(n0.y * side, n0.x * side);
+				float sweep = cross > 0 ? angle : -angle;
+				for (int k = 1; k < steps; k++) {
+					float a = a0 + sweep * k / steps;
+					arc.push_back(Point(p.x + h * std::cos(a), p.y + h * std::sin(a)));
+				}
+			}
+			arc.push_back(o1);
+
+			for (auto& o : arc) {
+				unsigned int oi = add(o);
+				if (side > 0) pair(oi, innerIdx);
+				else pair(innerIdx, oi);
+			}
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,250 @@
+#pragma once
+#ifndef _SURFACE_H_
+#define _SURFACE_H_
+
+#include <vector>
+#include <thread>
+#include <functional>
+#include <cmath>
+#include <algorithm>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+namespace Surface {
+
+	using std::vector;
+
+	// BezierƬƵ (degreeU + 1) x (degreeV + 1)
+	// iеjΪ points[i * (degreeV + 1) + j]
+	struct Patch {
+		int degreeU, degreeV;
+		vector<glm::vec3> points;
+
+		Patch(int degreeU_ = 3, int degreeV_ = 3)
+			: degreeU(degreeU_), degreeV(degreeV_), points((degreeU_ + 1) * (degreeV_ + 1)) {}
+
+		glm::vec3& at(int i, int j) {
+			return points[i * (degreeV + 1) + j];
+		}
+
+		const glm::vec3& at(int i, int j) const {
+			return points[i * (degreeV + 1) + j];
+		}
+	};
+
+	// ĳһĳһµBernsteinϵ䵼
+	// b[s * (degree + 1) + i] = B_i(t_s)t_s = s / segments
+	struct BasisTable {
+		int degree = -1, segments = 0;
+		vector<float> b, db;
+
+		void build(int degree_, int segments_) {
+			degree = degree_;
+			segments = segments_;
+			int m = degree + 1;
+			b.assign((size_t)(segments + 1) * m, 0.0f);
+			db.assign((size_t)(segments + 1) * m, 0.0f);
+			// һ׵ϵ󵼣B_i,n'(t) = n * (B_i-1,n-1(t) - B_i,n-1(t))
+			vector<double> cur(m), low(m);
+			for (int s = 0; s <= segments; s++) {
+				double t = (double)s / segments;
+				bernsteinAll(degree, t, cur);
+				bernsteinAll(degree - 1, t, low);
+				for (int i = 0; i < m; i++) {
+					b[(size_t)s * m + i] = (float)cur[i];
+					double a = i > 0 ? low[i - 1] : 0.0;
+					double c = i < degree ? low[i] : 0.0;
+					db[(size_t)s * m + i] = (float)(degree * (a - c));
+				}
+			}
+		}
+
+	private:
+		// õһȫnϵöʽϵpow
+		static void bernsteinAll(int n, double t, vector<double>& out) {
+			if (n < 0) return;
+			std::fill(out.begin(), out.end(), 0.0);
+			out[0] = 1.0;
+			for (int k = 1; k <= n; k++) {
+				for (int i = k; i >= 0; i--) {
+					out[i] = (1 - t) * out[i] + (i > 0 ? t * out[i - 1] : 0.0);
+				}
+			}
+		}
+	};
+
+	// һƬϸֳɴߵ񣬶ÿ6floatλ + ߣ
+	// HW6Phongɫlocation 0ΪaPos1ΪaNormalֱס
+	// ͬƬuvϵֻڽϸ仯ʱؽ
+	class Tessellator {
+	public:
+		vector<float> vertices;
+		vector<unsigned int> indices;
+
+		void tessellate(const vector<Patch>& patches, int segmentsU = 16, int segmentsV = 16, unsigned threads = 0) {
+			int n = (int)patches.size();
+			int perPatch = (segmentsU + 1) * (segmentsV + 1);
+			vertices.resize((size_t)n * perPatch * 6);
+
+			// ϵҪڿ߳ǰȫãֻ߳
+			for (auto& p : patches) {
+				table(p.degreeU, segmentsU);
+				table(p.degreeV, segmentsV);
+			}
+
+			indices.clear();
+			indices.reserve((size_t)n * segmentsU * segmentsV * 6);
+			for (int k = 0; k < n; k++) {
+				unsigned int base = (unsigned int)(k * perPatch);
+				for (int a = 0; a < segmentsU; a++) {
+					for (int c = 0; c < segmentsV; c++) {
+						unsigned int i0 = base + a * (segmentsV + 1) + c;
+						unsigned int i1 = i0 + segmentsV + 1;
+						indices.push_back(i0);
+						indices.push_back(i1);
+						indices.push_back(i0 + 1);
+						indices.push_back(i0 + 1);
+						indices.push_back(i1);
+						indices.push_back(i1 + 1);
+					}
+				}
+			}
+
+			if (threads == 0) threads = (std::max)(1u, std::thread::hardware_concurrency());
+			// ̫ʱ̲߳
+			if ((size_t)n * perPatch < 16384) threads = 1;
+			threads = (std::min<unsigned>)(threads, (std::max)(1, n));
+
+			if (threads == 1) {
+				tessellateRange(patches, 0, n, segmentsU, segmentsV);
+				return;
+			}
+			vector<std::thread> workers;
+			int chunk = (n + threads - 1) / threads;
+			for (unsigned i = 0; i < threads; i++) {
+				int from = i * chunk, to = (std::min)(n, from + chunk);
+				if (from >= to) break;
+				workers.emplace_back(&Tessellator::tessellateRange, this, std::cref(patches), from, to, segmentsU, segmentsV);
+			}
+			for (auto& w : workers) w.join();
+		}
+
+		void bind(GLuint& VAO, GLuint& VBO, GLuint& EBO) {
+			glGenVertexArrays(1, &VAO);
+			glGenBuffers(1, &VBO);
+			glGenBuffers(1, &EBO);
+			upload(VAO, VBO, EBO);
+		}
+
+		// ϸֺϴеĻ
+		void upload(GLuint VAO, GLuint VBO, GLuint EBO) {
+			glBindVertexArray(VAO);
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertices.size(), vertices.data(), GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indices.size(), indices.data(), GL_DYNAMIC_DRAW);
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+			glEnableVertexAttribArray(0);
+			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+			glEnableVertexAttribArray(1);
+		}
+
+		void draw(GLuint VAO) {
+			glBindVertexArray(VAO);
+			glDrawElements(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_INT, 0);
+		}
+
+	private:
+		vector<BasisTable> tables;
+
+		const BasisTable& table(int degree, int segments) {
+			for (auto& t : tables)
+				if (t.degree == degree && t.segments == segments) return t;
+			tables.push_back(BasisTable());
+			tables.back().build(degree, segments);
+			return tables.back();
+		}
+
+		const BasisTable& find(int degree, int segments) const {
+			for (auto& t : tables)
+				if (t.degree == degree && t.segments == segments) return t;
+			return tables.front();
+		}
+
+		// vÿһпƵϳһQ_i(v)ĵ
+		// uϳɣS = sum B_i(u) Q_iS_u = sum B_i'(u) Q_iS_v = sum B_i(u) Q_i'
+		void tessellateRange(const vector<Patch>& patches, int from, int to, int segmentsU, int segmentsV) {
+			vector<glm::vec3> q, dq;
+			for (int k = from; k < to; k++) {
+				const Patch& patch = patches[k];
+				const BasisTable& tu = find(patch.degreeU, segmentsU);
+				const BasisTable& tv = find(patch.degreeV, segmentsV);
+				int mu = patch.degreeU + 1, mv = patch.degreeV + 1;
+				q.resize(mu);
+				dq.resize(mu);
+				float* out = &vertices[(size_t)k * (segmentsU + 1) * (segmentsV + 1) * 6];
+
+				for (int c = 0; c <= segmentsV; c++) {
+					const float* bv = &tv.b[(size_t)c * mv];
+					const float* dbv = &tv.db[(size_t)c * mv];
+					for (int i = 0; i < mu; i++) {
+						glm::vec3 p(0.0f), d(0.0f);
+						for (int j = 0; j < mv; j++) {
+							p += bv[j] * patch.at(i, j);
+							d += dbv[j] * patch.at(i, j);
+						}
+						q[i] = p;
+						dq[i] = d;
+					}
+					for (int a = 0; a <= segmentsU; a++) {
+						const float* bu = &tu.b[(size_t)a * mu];
+						const float* dbu = &tu.db[(size_t)a * mu];
+						glm::vec3 s(0.0f), su(0.0f), sv(0.0f);
+						for (int i = 0; i < mu; i++) {
+							s += bu[i] * q[i];
+							su += dbu[i] * q[i];
+							sv += bu[i] * dq[i];
+						}
+						glm::vec3 normal = glm::cross(su, sv);
+						float len = glm::length(normal);
+						// ƵغϣճһıߣƫΪ0˶ȡƬķƫ
+						if (len < 1e-12f) normal = degenerateNormal(patch, (float)a / segmentsU, (float)c / segmentsV);
+						else normal /= len;
+
+						float* v = out + ((size_t)a * (segmentsV + 1) + c) * 6;
+						v[0] = s.x; v[1] = s.y; v[2] = s.z;
+						v[3] = normal.x; v[4] = normal.y; v[5] = normal.z;
+					}
+				}
+			}
+		}
+
+		// ˻ƬŲһߣֻãֱde Casteljau
+		static glm::vec3 degenerateNormal(const Patch& patch, float u, float v) {
+			const float eps = 1e-3f;
+			u = u < 0.5f ? u + eps : u - eps;
+			v = v < 0.5f ? v + eps : v - eps;
+			float h = 1e-4f;
+			glm::vec3 su = evalPoint(patch, u + h, v) - evalPoint(patch, u - h, v);
+			glm::vec3 sv = evalPoint(patch, u, v + h) - evalPoint(patch, u, v - h);
+			glm::vec3 n = glm::cross(su, sv);
+			float len = glm::length(n);
+			return len > 0 ? n / len : glm::vec3(0.0f, 0.0f, 1.0f);
+		}
+
+		static glm::vec3 evalPoint(const Patch& patch, float u, float v) {
+			vector<glm::vec3> row(patch.degreeV + 1), col(patch.degreeU + 1);
+			for (int i = 0; i <= patch.degreeU; i++) {
+				for (int j = 0; j <= patch.degreeV; j++) row[j] = patch.at(i, j);
+				for (int k = patch.degreeV; k > 0; k--)
+					for (int j = 0; j < k; j++) row[j] = (1 - v) * row[j] + v * row[j + 1];
+				col[i] = row[0];
+			}
+			for (int k = patch.degreeU; k > 0; k--)
+				for (int i = 0; i < k; i++) col[i] = (1 - u) * col[i] + u * col[i + 1];
+			return col[0];
+		}
+	};
+}
+
+#endif
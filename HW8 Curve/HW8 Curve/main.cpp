@@ -5,15 +5,31 @@
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "shader.h"
 #include "Bresenham.h"
 #include "Bezier.h"
+#include "BSpline.h"
+#include "ArcLength.h"
+#include "CurveCache.h"
+#include "Stroke.h"
+#include "PointIndex.h"
+#include "CurveQuery.h"
+#include "Bounds.h"
+#include "Surface.h"
+#include "Lod.h"
+#include "CurveFile.h"
+#include "VertexStream.h"
+#include <unordered_map>
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow *window);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 
-void drawControllerPoints(GLuint VAO, GLuint VBO, std::vector<Bezier::Point> controllerPoints);
+void drawControllerPoints(Stream::VertexStream& stream, const std::vector<Bezier::Point>& controllerPoints);
 void cursor_position_callback(GLFWwindow* window, double x, double y);
+Surface::Patch extrudePatch(const std::vector<Bezier::Point>& controllerPoints);
 
 // settings
 const unsigned int SCR_WIDTH = 800;
@@ -23,9 +39,10 @@ const char *vertexShaderSource = "#version 330 core\n"
 "layout (location = 0) in vec3 aPos;\n"
 "layout (location = 1) in vec3 aColor;\n"
 "out vec3 ourColor;\n"
+"uniform float zoom;\n"
 "void main()\n"
 "{\n"
-"   gl_Position = vec4(aPos, 1.0);\n"
+"   gl_Position = vec4(aPos.xy * zoom, aPos.z, 1.0);\n"
 "   ourColor = aColor;\n"
 "}\0";
 
@@ -39,10 +56,41 @@ const char *fragmentShaderSource = "#version 330 core\n"
 
 double mouse_x, mouse_y;
 std::vector<Bezier::Point> controllerPoints;
+// set whenever controllerPoints is edited, cleared once per-curve caches are rebuilt
+bool controllerChanged = true;
 
 bool show_assistant = true;
+bool use_cubic = false;
+bool use_bspline = false;
+bool use_stroke = false;
+bool show_surface = false;
+bool use_lod = false;
+float zoom = 1.0f;
+float strokeWidth = 3.0f; // in pixels
+int strokeJoin = Stroke::ROUND;
 float speed = 0.05f;
 float lastTab = -1000.0f;
+float lastC = -1000.0f;
+float lastB = -1000.0f;
+float lastS = -1000.0f;
+float lastL = -1000.0f;
+const char* CURVE_FILE = "curves.bzc";
+
+// cubic B-spline through the same control points, updated span by span
+BSpline::Curve bspline(3, BSpline::CLAMPED);
+
+// grid index over the control points for picking; ids stay fixed while indices shift on erase
+const float PICK_GAP = 0.02f;
+Bezier::PointIndex pointIndex(PICK_GAP);
+std::vector<int> controllerIds;
+std::unordered_map<int, int> controllerIndex;  // id -> index into controllerPoints
+int nextControllerId = 0;
+int draggingPoint = -1;  // index into controllerPoints while the left button is held
+int hoveredPoint = -1;
+
+void addControllerPoint(Bezier::Point p);
+void loadControllerPoints(const std::vector<Bezier::Point>& ps);
+int pickControllerPoint(float x, float y);
 
 int main()
 {
@@ -124,22 +172,9 @@ int main()
 
 	// set up vertex data (and buffer(s)) and configure vertex attributes
 	// ------------------------------------------------------------------	
-	float vertices[] = {
-		1.0f, -1.0f, 0.0f, 
-		0.0f, 1.0f, 0.0f, 
-		-1.0f, -1.0f, 0.0f
-	};
-	unsigned int VBO, VAO;
-	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
-	// bind the Vertex Array Object first, then bind and set vertex buffer(s), and then configure vertex attributes(s).
-	glBindVertexArray(VAO);
-
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-	glEnableVertexAttribArray(0);
+	// control points and the hover marker change every frame, they are written straight into a streamed buffer
+	Stream::VertexStream stream;
+	stream.create(3, 1024, (GLADloadproc)glfwGetProcAddress);
 
 	// Bresenham algorithm
 	float triVertices[6] = {-0.9f, 0.2f, 0.9f, 0.7f, 0.1f, -0.5f};
@@ -151,8 +186,11 @@ int main()
 			Bresenham::Point(-0.5f, 0.2f),
 			Bresenham::Point(-0.08f, 1.0f));
 
-	unsigned int HW3B1_VAO, HW3B1_VBO;
-	Bresenham::pointsBindVAO(HW3B1_VAO, HW3B1_VBO, triPoints);
+	// the assistant lines live in a sub-allocation of a shared buffer pool and are updated in place
+	Pool::BufferPool bufferPool;
+	unsigned int HW3B1_VAO = 0;
+	Pool::Range HW3B1_range;
+	Bresenham::pointsBindVAO(bufferPool, HW3B1_VAO, HW3B1_range, triPoints);
 
 	// as we only have a single shader, we could also just activate our shader once beforehand if we want to 
 	glUseProgram(shaderProgram);
@@ -161,11 +199,58 @@ int main()
 	//controllerPoints.push_back(Bezier::Point(-1.0f, -0.9f));
 	//controllerPoints.push_back(Bezier::Point(0.9f, 0.9f));
 	
-	controllerPoints.push_back(Bezier::Point(-0.9f, -0.5f));
-	controllerPoints.push_back(Bezier::Point(-0.9f, 0.2f));
-	controllerPoints.push_back(Bezier::Point(0.7f, 0.8f));
+	addControllerPoint(Bezier::Point(-0.9f, -0.5f));
+	addControllerPoint(Bezier::Point(-0.9f, 0.2f));
+	addControllerPoint(Bezier::Point(0.7f, 0.8f));
+	unsigned int bsplineVAO, bsplineVBO;
+	Bezier::pointsBindVAO(bsplineVAO, bsplineVBO, bspline.vertices);
 	
 	float tLimit = 0.0f, lastTime = 0.0f;
+	// animation progress as a fraction of the arc length, so the drawing speed is constant
+	float sLimit = 0.0f;
+	Bezier::ArcLengthTable arcTable;
+
+	// curve samples are evaluated once per control point edit and appended as tLimit grows
+	Bezier::CurveSampleCache curveCache;
+	std::vector<Bezier::CubicSegment> cubicSegments;
+	const std::vector<Bezier::CubicSegment> noSegments;
+	bool cachedCubic = use_cubic;
+	unsigned int curveVAO, curveVBO;
+	Bezier::pointsBindVAO(curveVAO, curveVBO, curveCache.vertices);
+
+	// assistant lines only change when tLimit or the control points change
+	std::vector<float> assistantLine;
+	float assistantT = -1.0f;
+
+	// stroked curve, rebuilt only when tLimit, the style or the control points change
+	Stroke::Stroker stroker;
+	Stroke::Style strokeStyle;
+	strokeStyle.cap = Stroke::ROUND_CAP;
+	float strokeT = -1.0f;
+	unsigned int strokeVAO, strokeVBO, strokeEBO;
+	glGenVertexArrays(1, &strokeVAO);
+	glGenBuffers(1, &strokeVBO);
+	glGenBuffers(1, &strokeEBO);
+
+	// exact bounds and control hull of the curve, used to skip sampling and stroking while it is off screen
+	Bezier::Curve curveBounds;
+
+	// nearest point on the curve to the cursor, the hierarchy is rebuilt with the control points
+	Bezier::CurveHierarchy curveHierarchy;
+	Bezier::CurveHit curveHover;
+
+	// the curve extruded along z into a Bezier patch, lit by the HW6 Phong shader
+	Shader phongShader("hw6.vs", "hw6.fs");
+	Surface::Tessellator tessellator;
+	bool surfaceDirty = true;
+	unsigned int surfaceVAO, surfaceVBO, surfaceEBO;
+	tessellator.bind(surfaceVAO, surfaceVBO, surfaceEBO);
+
+	// curve sampled by its size on screen, one cached buffer per power-of-two LOD level
+	Bezier::LodCache lodCache;
+	unsigned int lodVAO, lodVBO;
+	std::vector<float> noVertices;
+	Bezier::pointsBindVAO(lodVAO, lodVBO, noVertices);
 
 	// render loop
 	// -----------
@@ -179,6 +264,19 @@ int main()
 		ImGui_ImplGlfw_NewFrame();
 		ImGui::NewFrame();
 		ImGui::Text("TAB to switch whether to show the assistant line, up and down to adjust speed.");
+		ImGui::Text("C to switch piecewise cubic approximation: %s", use_cubic ? "on" : "off");
+		ImGui::Text("B to switch B-spline: %s", use_bspline ? "on" : "off");
+		ImGui::Text("S to save the control points to %s, L to load them back", CURVE_FILE);
+		ImGui::Checkbox("stroke the curve", &use_stroke);
+		ImGui::Checkbox("extrude into a surface", &show_surface);
+		ImGui::SliderFloat("zoom", &zoom, 0.05f, 4.0f);
+		ImGui::Checkbox("screen-space LOD", &use_lod);
+		if (use_lod) ImGui::Text("LOD level %d: %d vertices", lodCache.level(), lodCache.segments() + 1);
+		ImGui::SliderFloat("stroke width", &strokeWidth, 1.0f, 30.0f);
+		ImGui::RadioButton("miter", &strokeJoin, Stroke::MITER); ImGui::SameLine();
+		ImGui::RadioButton("round", &strokeJoin, Stroke::ROUND); ImGui::SameLine();
+		ImGui::RadioButton("bevel", &strokeJoin, Stroke::BEVEL);
+		if (curveHover.curve >= 0) ImGui::Text("cursor on curve: t = %.4f", curveHover.t);
 		ImGui::Render();
 
 		int display_w, display_h;
@@ -188,36 +286,141 @@ int main()
 
 		// render
 		// ------
+		stream.beginFrame();
 
 		// update shader uniform
 		int vertexColorLocation = glGetUniformLocation(shaderProgram, "ourColor");
 		glUniform4f(vertexColorLocation, clear_color.x, clear_color.y, clear_color.z, clear_color.w);
+		glUniform1f(glGetUniformLocation(shaderProgram, "zoom"), zoom);
+
+		if (controllerChanged || cachedCubic != use_cubic) {
+			arcTable.build(controllerPoints);
+			curveHierarchy.build(controllerPoints);
+			curveBounds.setPoints(controllerPoints);
+			if (use_cubic) cubicSegments = Bezier::toPiecewiseCubic(controllerPoints);
+			curveCache.invalidate();
+			assistantT = -1.0f;
+			strokeT = -1.0f;
+			surfaceDirty = true;
+			lodCache.invalidate();
+			cachedCubic = use_cubic;
+			controllerChanged = false;
+		}
 
 		if (!show_assistant) {
 			tLimit = 1.0f;
 		} else if ((float)glfwGetTime() - lastTime > 0.1f) {
 			lastTime = (float)glfwGetTime();
-			tLimit += speed;
-			if (tLimit >= 1.0f) {
-				tLimit = 0.0f;
+			sLimit += speed;
+			if (sLimit >= 1.0f) {
+				sLimit = 0.0f;
 			}
+			tLimit = arcTable.tAtFraction(sLimit);
 		}
 
-		std::vector<float> triPoints = Bezier::genBezierCurvePoints(controllerPoints, tLimit);
+		glClear(GL_COLOR_BUFFER_BIT);
+		if (show_surface && controllerPoints.size() >= 2) {
+			if (surfaceDirty) {
+				tessellator.tessellate(std::vector<Surface::Patch>(1, extrudePatch(controllerPoints)), 32, 8);
+				tessellator.upload(surfaceVAO, surfaceVBO, surfaceEBO);
+				surfaceDirty = false;
+			}
+			glm::mat4 model = glm::rotate(glm::mat4(1.0f), 0.5f * (float)glfwGetTime(), glm::vec3(0.0f, 1.0f, 0.0f));
+			glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -3.0f));
+			glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.01f, 50.0f);
+
+			glEnable(GL_DEPTH_TEST);
+			glClear(GL_DEPTH_BUFFER_BIT);
+			phongShader.use();
+			phongShader.setVec3("objectColor", 1.0f, 0.5f, 0.31f);
+			phongShader.setVec3("lightColor", 1.0f, 1.0f, 1.0f);
+			phongShader.setVec3("lightPos", 1.2f, 1.0f, 2.0f);
+			phongShader.setVec3("viewPos", 0.0f, 0.0f, 3.0f);
+			phongShader.setMat4("model", model);
+			phongShader.setMat4("view", view);
+			phongShader.setMat4("projection", projection);
+			phongShader.setFloat("ambientStrength", 0.2f);
+			phongShader.setFloat("diffuseStrength", 0.0f);
+			phongShader.setFloat("specularStrength", 0.5f);
+			tessellator.draw(surfaceVAO);
+			glDisable(GL_DEPTH_TEST);
+			glUseProgram(shaderProgram);
+		}
+		// the shader scales by zoom, so NDC [-1, 1] shows [-1 / zoom, 1 / zoom] of curve space;
+		// pad by the stroke width (and a pixel for the sampled paths) so the caps and joins near the edge stay drawn
+		float pad = (std::max)(strokeWidth, 1.0f) * 2.0f / SCR_WIDTH / zoom;
+		Bezier::AABB view(-1.0f / zoom - pad, -1.0f / zoom - pad, 1.0f / zoom + pad, 1.0f / zoom + pad);
+		bool curveVisible = !controllerPoints.empty() && curveBounds.visible(view);
+		if (!curveVisible) {
+			// off screen: nothing to sample, flatten or stroke; the caches pick up where they were once it comes back
+		} else if (use_stroke) {
+			float width = strokeWidth * 2.0f / SCR_WIDTH / zoom;
+			if (strokeT != tLimit || strokeStyle.width != width || strokeStyle.join != strokeJoin) {
+				strokeStyle.width = width;
+				strokeStyle.join = (Stroke::Join)strokeJoin;
+				// flatten to half a pixel, so straight parts collapse to a few vertices
+				float tolerance = 0.5f / SCR_WIDTH / zoom;
+				stroker.stroke(use_cubic
+					? Stroke::flatten(cubicSegments, tolerance, 0.0f, tLimit)
+					: Stroke::flatten(controllerPoints, tolerance, 0.0f, tLimit), strokeStyle);
+				stroker.bind(strokeVAO, strokeVBO, strokeEBO);
+				strokeT = tLimit;
+			}
+			stroker.draw(strokeVAO);
+		} else if (use_lod) {
+			// NDC spans 2 units, so one unit is half the window times the zoom in pixels
+			lodCache.vertices(controllerPoints, zoom * SCR_WIDTH / 2, zoom * SCR_HEIGHT / 2,
+				use_cubic ? cubicSegments : noSegments);
+			lodCache.upload(lodVBO);
+			int segments = lodCache.segments();
+			int lodCount = (std::min)(segments + 1, (int)std::floor(tLimit * segments) + 1);
+			glBindVertexArray(lodVAO);
+			glDrawArrays(GL_LINE_STRIP, 0, controllerPoints.size() >= 2 ? lodCount : 0);
+		} else {
+			int curveCount = use_cubic
+				? curveCache.extend(cubicSegments, tLimit)
+				: curveCache.extend(controllerPoints, tLimit);
+			curveCache.upload(curveVBO);
+
+			glBindVertexArray(curveVAO);
+			glPointSize(1);
+			glDrawArrays(GL_POINTS, 0, curveCount);
+		}
 
 		if (show_assistant) {
-			std::vector<float> assistantLine = Bezier::genAssistantLinePoints(controllerPoints, tLimit);
-			triPoints.insert(triPoints.end(), assistantLine.begin(), assistantLine.end());
+			if (assistantT != tLimit) {
+				assistantLine.clear();
+				Bezier::genAssistantLinePoints(controllerPoints, tLimit, assistantLine);
+				Bresenham::pointsBindVAO(bufferPool, HW3B1_VAO, HW3B1_range, assistantLine);
+				assistantT = tLimit;
+			}
+			glBindVertexArray(HW3B1_VAO);
+			glDrawArrays(GL_LINES, 0, assistantLine.size() / 3);
 		}
 
-		glBindVertexArray(HW3B1_VAO);
-		glBindBuffer(GL_ARRAY_BUFFER, HW3B1_VBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * triPoints.size(), triPoints.data(), GL_DYNAMIC_DRAW);
-		glPointSize(1);
-		glClear(GL_COLOR_BUFFER_BIT);
-		glDrawArrays(GL_POINTS, 0, triPoints.size() / 3);
+		if (use_bspline) {
+			// only the spans touched since the last frame are uploaded
+			bspline.upload(bsplineVBO);
+			glBindVertexArray(bsplineVAO);
+			glDrawArrays(GL_LINE_STRIP, 0, bspline.vertexCount());
+		}
 
-		drawControllerPoints(VAO, VBO, controllerPoints);
+		drawControllerPoints(stream, controllerPoints);
+
+		// highlight the closest curve point when the cursor is near the curve but not on a control point
+		curveHover = hoveredPoint < 0
+			? curveHierarchy.nearest(Bezier::Point(mouse_x, mouse_y), 3 * PICK_GAP / zoom)
+			: Bezier::CurveHit();
+		if (curveHover.curve >= 0) {
+			float* foot = stream.map(1);
+			foot[0] = curveHover.p.x;
+			foot[1] = curveHover.p.y;
+			foot[2] = 0.0f;
+			GLint first = stream.unmap();
+			glPointSize(8);
+			stream.draw(GL_POINTS, first, 1);
+		}
+		stream.endFrame();
 		
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 		glfwMakeContextCurrent(window);
@@ -230,9 +433,20 @@ int main()
 	// optional: de-allocate all resources once they've outlived their purpose:
 	// ------------------------------------------------------------------------ 
 	glDeleteVertexArrays(1, &HW3B1_VAO);
-	glDeleteBuffers(1, &HW3B1_VBO);
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(1, &VBO);
+	bufferPool.destroy();
+	glDeleteVertexArrays(1, &bsplineVAO);
+	glDeleteBuffers(1, &bsplineVBO);
+	glDeleteVertexArrays(1, &curveVAO);
+	glDeleteBuffers(1, &curveVBO);
+	glDeleteVertexArrays(1, &strokeVAO);
+	glDeleteBuffers(1, &strokeVBO);
+	glDeleteBuffers(1, &strokeEBO);
+	stream.destroy();
+	glDeleteVertexArrays(1, &surfaceVAO);
+	glDeleteBuffers(1, &surfaceVBO);
+	glDeleteBuffers(1, &surfaceEBO);
+	glDeleteVertexArrays(1, &lodVAO);
+	glDeleteBuffers(1, &lodVBO);
 	// glfw: terminate, clearing all previously allocated GLFW resources.
 	// ------------------------------------------------------------------
 	glfwTerminate();
@@ -260,6 +474,33 @@ void processInput(GLFWwindow *window)
 			lastTab = glfwGetTime();
 		}
 	}
+	if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS) {
+		if (glfwGetTime() - lastC > 0.3f) {
+			use_cubic = !use_cubic;
+			lastC = glfwGetTime();
+		}
+	}
+	if (glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS) {
+		if (glfwGetTime() - lastB > 0.3f) {
+			use_bspline = !use_bspline;
+			lastB = glfwGetTime();
+		}
+	}
+	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
+		if (glfwGetTime() - lastS > 0.3f) {
+			if (!Bezier::saveCurves(CURVE_FILE, std::vector<std::vector<Bezier::Point>>(1, controllerPoints)))
+				std::cout << "Failed to save " << CURVE_FILE << std::endl;
+			lastS = glfwGetTime();
+		}
+	}
+	if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
+		if (glfwGetTime() - lastL > 0.3f) {
+			Bezier::CurveFile file;
+			if (file.open(CURVE_FILE) && file.size() > 0) loadControllerPoints(file.curve(0));
+			else std::cout << "Failed to load " << CURVE_FILE << std::endl;
+			lastL = glfwGetTime();
+		}
+	}
 }
 
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
@@ -271,23 +512,73 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 	glViewport(0, 0, width, height);
 }
 
-void deleteControllerPoint(float mouse_x, float mouse_y) {
-	float gap = 0.02f;
-	for (auto it = controllerPoints.begin(); it != controllerPoints.end(); it++) {
-		if (abs(it->x - mouse_x) < gap && abs(it->y - mouse_y) < gap) {
-			it = controllerPoints.erase(it);
-			break;
-		}
+void addControllerPoint(Bezier::Point p) {
+	controllerPoints.push_back(p);
+	controllerIndex[nextControllerId] = (int)controllerIds.size();
+	controllerIds.push_back(nextControllerId);
+	pointIndex.insert(nextControllerId++, p);
+	bspline.insertControlPoint((int)bspline.points.size(), p);
+	controllerChanged = true;
+}
+
+// replace every control point, e.g. after loading a curve file
+void loadControllerPoints(const std::vector<Bezier::Point>& ps) {
+	controllerPoints.clear();
+	controllerIds.clear();
+	controllerIndex.clear();
+	pointIndex.clear();
+	for (auto& p : ps) {
+		controllerPoints.push_back(p);
+		controllerIndex[nextControllerId] = (int)controllerIds.size();
+		controllerIds.push_back(nextControllerId);
+		pointIndex.insert(nextControllerId++, p);
 	}
+	bspline.setPoints(controllerPoints);
+	draggingPoint = hoveredPoint = -1;
+	controllerChanged = true;
+}
+
+// index of the control point within PICK_GAP on screen of (x, y), or -1
+int pickControllerPoint(float x, float y) {
+	int id = pointIndex.nearest(Bezier::Point(x, y), PICK_GAP / zoom);
+	if (id < 0) return -1;
+	return controllerIndex.at(id);
+}
+
+void deleteControllerPoint(float mouse_x, float mouse_y) {
+	int i = pickControllerPoint(mouse_x, mouse_y);
+	if (i < 0) return;
+	pointIndex.remove(controllerIds[i]);
+	controllerIndex.erase(controllerIds[i]);
+	bspline.eraseControlPoint(i);
+	controllerPoints.erase(controllerPoints.begin() + i);
+	controllerIds.erase(controllerIds.begin() + i);
+	// the points after i shift down by one
+	for (int j = i; j < (int)controllerIds.size(); j++) controllerIndex[controllerIds[j]] = j;
+	if (draggingPoint == i) draggingPoint = -1;
+	else if (draggingPoint > i) draggingPoint--;
+	hoveredPoint = -1;
+	controllerChanged = true;
+}
+
+void moveControllerPoint(int i, Bezier::Point p) {
+	controllerPoints[i] = p;
+	pointIndex.move(controllerIds[i], p);
+	bspline.moveControlPoint(i, p);
+	controllerChanged = true;
 }
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
 	if (action == GLFW_PRESS) {
+		// clicks on the ImGui panel belong to its widgets, not the canvas
+		if (ImGui::GetIO().WantCaptureMouse) return;
 		switch (button)
 		{
 		case GLFW_MOUSE_BUTTON_LEFT:
-			controllerPoints.insert(controllerPoints.end(), Bezier::Point(mouse_x, mouse_y));
+			// pressing on an existing point drags it, anywhere else adds a new one
+			draggingPoint = pickControllerPoint(mouse_x, mouse_y);
+			if (draggingPoint < 0) addControllerPoint(Bezier::Point(mouse_x, mouse_y));
 			break;
 		case GLFW_MOUSE_BUTTON_MIDDLE:
 			std::cout << "Mosue middle button clicked!" << std::endl;
@@ -300,24 +591,53 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 			return;
 		}
 	}
+	else if (action == GLFW_RELEASE && button == GLFW_MOUSE_BUTTON_LEFT) {
+		draggingPoint = -1;
+	}
 	return;
 }
 
-void drawControllerPoints(GLuint VAO, GLuint VBO, std::vector<Bezier::Point> controllerPoints)
+void drawControllerPoints(Stream::VertexStream& stream, const std::vector<Bezier::Point>& controllerPoints)
 {
-	std::vector<float> controllerPointsVecFloat3 = Bezier::pointsToFloat3(controllerPoints);
-	//std::cout << controllerPointsVecFloat3[0] << " " << controllerPointsVecFloat3[1] << " " << controllerPointsVecFloat3[2] << std::endl;
-	//std::cout << controllerPointsVecFloat3[3] << " " << controllerPointsVecFloat3[4] << " " << controllerPointsVecFloat3[5] << std::endl;
-
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * controllerPointsVecFloat3.size(), controllerPointsVecFloat3.data(), GL_STATIC_DRAW);
+	int n = (int)controllerPoints.size();
+	float* out = stream.map(n);
+	for (int i = 0; i < n; i++) {
+		out[i * 3] = controllerPoints[i].x;
+		out[i * 3 + 1] = controllerPoints[i].y;
+		out[i * 3 + 2] = 0.0f;
+	}
+	GLint first = stream.unmap();
 	glPointSize(10);
-	glDrawArrays(GL_POINTS, 0, controllerPointsVecFloat3.size() / 3);
+	stream.draw(GL_POINTS, first, n);
+	if (hoveredPoint >= 0 && hoveredPoint < n) {
+		glPointSize(16);
+		stream.draw(GL_POINTS, first + hoveredPoint, 1);
+	}
 }
 
 void cursor_position_callback(GLFWwindow* window, double x, double y)
 {
-	mouse_x = float((x - SCR_WIDTH / 2) / SCR_WIDTH) * 2;
-	mouse_y = float(0 - (y - SCR_HEIGHT / 2) / SCR_HEIGHT) * 2;
-}
\ No newline at end of file
+	mouse_x = float((x - SCR_WIDTH / 2) / SCR_WIDTH) * 2 / zoom;
+	mouse_y = float(0 - (y - SCR_HEIGHT / 2) / SCR_HEIGHT) * 2 / zoom;
+	// over the panel (or while an ImGui widget is being dragged) nothing on the canvas is hovered or moved
+	if (ImGui::GetIO().WantCaptureMouse) {
+		hoveredPoint = -1;
+		return;
+	}
+	if (draggingPoint >= 0) moveControllerPoint(draggingPoint, Bezier::Point(mouse_x, mouse_y));
+	hoveredPoint = draggingPoint >= 0 ? draggingPoint : pickControllerPoint(mouse_x, mouse_y);
+}
+
+// control point i becomes row i of the patch, swept along z through four columns
+// whose middle two are pinched towards the x axis
+Surface::Patch extrudePatch(const std::vector<Bezier::Point>& controllerPoints)
+{
+	Surface::Patch patch((int)controllerPoints.size() - 1, 3);
+	for (int i = 0; i <= patch.degreeU; i++) {
+		for (int j = 0; j <= 3; j++) {
+			float pinch = (j == 1 || j == 2) ? 0.5f : 1.0f;
+			patch.at(i, j) = glm::vec3(controllerPoints[i].x, controllerPoints[i].y * pinch, j / 3.0f - 0.5f);
+		}
+	}
+	return patch;
+}